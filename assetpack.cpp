@@ -0,0 +1,322 @@
+/*******************************************************************************************
+*
+*   assetpack - indexed archive of pre-decoded assets, memory mapped at startup
+*
+*   Layout (little endian):
+*       header  "BTBP", version u32, entry count u32, reserved u32
+*       entries name[64] (NUL padded), kind u32, offset u32, size u32,
+*               then per kind: image width, height, format, mipmaps
+*                              wave  sampleCount, sampleRate, sampleSize, channels
+*               reserved u32
+*       data    every entry at a multiple of ASSET_PACK_ALIGN
+*
+********************************************************************************************/
+
+#include "assetpack.h"
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <vector>
+using namespace std;
+
+#if defined(_WIN32) || defined(PLATFORM_WEB)
+    #define PACK_NO_MMAP        // read into memory instead
+#else
+    #include <fcntl.h>
+    #include <sys/mman.h>
+    #include <sys/stat.h>
+    #include <unistd.h>
+#endif
+
+#define PACK_HEADER_SIZE    16
+#define PACK_ENTRY_SIZE     (ASSET_PACK_NAME_LENGTH + 4*8)
+
+enum PackKind { PACK_RAW = 0, PACK_IMAGE, PACK_WAVE };
+
+static const unsigned char packMagic[4] = { 'B', 'T', 'B', 'P' };
+
+typedef struct PackEntry {
+    char name[ASSET_PACK_NAME_LENGTH];
+    uint32_t kind;
+    uint32_t offset;
+    uint32_t size;
+    uint32_t info[4];       // PackKind specific, see the layout above
+} PackEntry;
+
+//----------------------------------------------------------------------------------
+// Global Variables Definition (local)
+//----------------------------------------------------------------------------------
+static const unsigned char *packData = NULL;
+static size_t packSize = 0;
+static vector<PackEntry> packEntries;
+
+//----------------------------------------------------------------------------------
+// Module Functions Definitions (local)
+//----------------------------------------------------------------------------------
+static void putU32(unsigned char *out, uint32_t value)
+{
+    for (int i = 0; i < 4; i++) out[i] = (unsigned char)(value >> (8*i));
+}
+
+static uint32_t getU32(const unsigned char *in)
+{
+    uint32_t value = 0;
+    for (int i = 0; i < 4; i++) value |= (uint32_t)in[i] << (8*i);
+    return value;
+}
+
+static const char *EntryName(const char *fileName)
+{
+    while (fileName[0] == '.' && fileName[1] == '/') fileName += 2;
+    return fileName;
+}
+
+// A few entries, a linear scan over the table is all it takes
+static const PackEntry *FindEntry(const char *fileName, uint32_t kind)
+{
+    const char *name = EntryName(fileName);
+    for (int e = 0; e < (int)packEntries.size(); e++) {
+        if (packEntries[e].kind == kind && strcmp(packEntries[e].name, name) == 0) return &packEntries[e];
+    }
+    return NULL;
+}
+
+static bool HasExtension(const char *fileName, const char *extension)
+{
+    size_t length = strlen(fileName), extensionLength = strlen(extension);
+    return length > extensionLength && strcmp(fileName + length - extensionLength, extension) == 0;
+}
+
+static bool ReadWholeFile(const char *fileName, vector<unsigned char> &data)
+{
+    FILE *file = fopen(fileName, "rb");
+    if (file == NULL) return false;
+
+    fseek(file, 0, SEEK_END);
+    long length = ftell(file);
+    fseek(file, 0, SEEK_SET);
+    data.resize(length > 0? length : 0);
+    bool ok = length >= 0 && fread(data.data(), 1, data.size(), file) == data.size();
+    fclose(file);
+    return ok;
+}
+
+static bool ParseTable(void)
+{
+    if (packSize < PACK_HEADER_SIZE || memcmp(packData, packMagic, 4) != 0) return false;
+    if (getU32(packData + 4) != ASSET_PACK_VERSION) return false;
+
+    uint32_t count = getU32(packData + 8);
+    if (count > (packSize - PACK_HEADER_SIZE)/PACK_ENTRY_SIZE) return false;
+
+    packEntries.resize(count);
+    for (uint32_t e = 0; e < count; e++) {
+        const unsigned char *in = packData + PACK_HEADER_SIZE + e*PACK_ENTRY_SIZE;
+        PackEntry &entry = packEntries[e];
+        memcpy(entry.name, in, ASSET_PACK_NAME_LENGTH);
+        entry.name[ASSET_PACK_NAME_LENGTH - 1] = '\0';
+        in += ASSET_PACK_NAME_LENGTH;
+        entry.kind = getU32(in);
+        entry.offset = getU32(in + 4);
+        entry.size = getU32(in + 8);
+        for (int i = 0; i < 4; i++) entry.info[i] = getU32(in + 12 + 4*i);
+
+        if ((uint64_t)entry.offset + entry.size > packSize) return false;
+        if (entry.kind == PACK_IMAGE && (uint64_t)entry.info[0]*entry.info[1]*4 != entry.size) return false;
+    }
+
+    return true;
+}
+
+//----------------------------------------------------------------------------------
+// Module Functions Definitions
+//----------------------------------------------------------------------------------
+bool MountAssetPack(const char *fileName)
+{
+    UnmountAssetPack();
+
+#if defined(PACK_NO_MMAP)
+    vector<unsigned char> data;
+    if (!ReadWholeFile(fileName, data) || data.empty()) return false;
+    unsigned char *copy = (unsigned char *)malloc(data.size());
+    memcpy(copy, data.data(), data.size());
+    packData = copy;
+    packSize = data.size();
+#else
+    int fd = open(fileName, O_RDONLY);
+    if (fd < 0) return false;
+
+    struct stat info;
+    void *mapping = MAP_FAILED;
+    if (fstat(fd, &info) == 0 && info.st_size > 0) mapping = mmap(NULL, info.st_size, PROT_READ, MAP_PRIVATE, fd, 0);
+    close(fd);      // the mapping keeps the file
+    if (mapping == MAP_FAILED) return false;
+
+    packData = (const unsigned char *)mapping;
+    packSize = info.st_size;
+#endif
+
+    if (!ParseTable()) {
+        printf("assetpack: %s is damaged or from another version, loading the files instead\n", fileName);
+        UnmountAssetPack();
+        return false;
+    }
+
+    return true;
+}
+
+void UnmountAssetPack(void)
+{
+#if defined(PACK_NO_MMAP)
+    free((void *)packData);
+#else
+    if (packData != NULL) munmap((void *)packData, packSize);
+#endif
+
+    packData = NULL;
+    packSize = 0;
+    packEntries.clear();
+}
+
+bool IsAssetPacked(const char *fileName)
+{
+    const char *name = EntryName(fileName);
+    for (int e = 0; e < (int)packEntries.size(); e++) {
+        if (strcmp(packEntries[e].name, name) == 0) return true;
+    }
+    return false;
+}
+
+bool GetPackedImage(const char *fileName, Image *image)
+{
+    const PackEntry *entry = FindEntry(fileName, PACK_IMAGE);
+    if (entry == NULL) return false;
+
+    image->data = (void *)(packData + entry->offset);
+    image->width = entry->info[0];
+    image->height = entry->info[1];
+    image->format = entry->info[2];
+    image->mipmaps = entry->info[3];
+    return true;
+}
+
+bool GetPackedWave(const char *fileName, Wave *wave)
+{
+    const PackEntry *entry = FindEntry(fileName, PACK_WAVE);
+    if (entry == NULL) return false;
+
+    wave->data = (void *)(packData + entry->offset);
+    wave->sampleCount = entry->info[0];
+    wave->sampleRate = entry->info[1];
+    wave->sampleSize = entry->info[2];
+    wave->channels = entry->info[3];
+    return true;
+}
+
+const unsigned char *GetPackedData(const char *fileName, int *size)
+{
+    const PackEntry *entry = FindEntry(fileName, PACK_RAW);
+    if (entry == NULL) return NULL;
+
+    *size = (int)entry->size;
+    return packData + entry->offset;
+}
+
+// Images go in as RGBA8, audio as 16-bit PCM, anything else verbatim
+bool BuildAssetPack(const char *packPath, const char **files, int count)
+{
+    vector<PackEntry> entries(count);
+    vector< vector<unsigned char> > blobs(count);
+    uint32_t offset = PACK_HEADER_SIZE + count*PACK_ENTRY_SIZE;
+    bool ok = true;
+
+    for (int f = 0; ok && f < count; f++) {
+        PackEntry &entry = entries[f];
+        const char *name = EntryName(files[f]);
+        memset(&entry, 0, sizeof(entry));
+        if (strlen(name) >= ASSET_PACK_NAME_LENGTH) {
+            printf("assetpack: name too long: %s\n", name);
+            ok = false;
+            break;
+        }
+        strcpy(entry.name, name);
+
+        if (HasExtension(name, ".png")) {
+            Image image = LoadImage(files[f]);
+            ok = image.data != NULL;
+            if (ok) {
+                ImageFormat(&image, PIXELFORMAT_UNCOMPRESSED_R8G8B8A8);
+                const unsigned char *pixels = (const unsigned char *)image.data;
+                blobs[f].assign(pixels, pixels + image.width*image.height*4);
+                entry.kind = PACK_IMAGE;
+                entry.info[0] = image.width;
+                entry.info[1] = image.height;
+                entry.info[2] = image.format;
+                entry.info[3] = 1;      // mipmaps are not kept
+                UnloadImage(image);
+            }
+        }
+        else if (HasExtension(name, ".wav") || HasExtension(name, ".ogg")) {
+            Wave wave = LoadWave(files[f]);
+            ok = wave.data != NULL;
+            if (ok) {
+                if (wave.sampleSize != 16) WaveFormat(&wave, wave.sampleRate, 16, wave.channels);     // what the mixer plays
+                // sampleCount counts the samples of every channel
+                const unsigned char *samples = (const unsigned char *)wave.data;
+                blobs[f].assign(samples, samples + wave.sampleCount*(wave.sampleSize/8));
+                entry.kind = PACK_WAVE;
+                entry.info[0] = wave.sampleCount;
+                entry.info[1] = wave.sampleRate;
+                entry.info[2] = wave.sampleSize;
+                entry.info[3] = wave.channels;
+                UnloadWave(wave);
+            }
+        }
+        else {
+            ok = ReadWholeFile(files[f], blobs[f]);
+            entry.kind = PACK_RAW;
+        }
+        if (!ok) {
+            printf("assetpack: could not load %s\n", files[f]);
+            break;
+        }
+
+        offset = (offset + ASSET_PACK_ALIGN - 1)/ASSET_PACK_ALIGN*ASSET_PACK_ALIGN;
+        entry.offset = offset;
+        entry.size = (uint32_t)blobs[f].size();
+        offset += entry.size;
+    }
+    if (!ok) return false;
+
+    FILE *file = fopen(packPath, "wb");
+    if (file == NULL) return false;
+
+    unsigned char header[PACK_HEADER_SIZE] = { 0 };
+    memcpy(header, packMagic, 4);
+    putU32(header + 4, ASSET_PACK_VERSION);
+    putU32(header + 8, count);
+    fwrite(header, 1, sizeof(header), file);
+
+    for (int f = 0; f < count; f++) {
+        unsigned char out[PACK_ENTRY_SIZE] = { 0 };
+        memcpy(out, entries[f].name, ASSET_PACK_NAME_LENGTH);
+        putU32(out + ASSET_PACK_NAME_LENGTH, entries[f].kind);
+        putU32(out + ASSET_PACK_NAME_LENGTH + 4, entries[f].offset);
+        putU32(out + ASSET_PACK_NAME_LENGTH + 8, entries[f].size);
+        for (int i = 0; i < 4; i++) putU32(out + ASSET_PACK_NAME_LENGTH + 12 + 4*i, entries[f].info[i]);
+        fwrite(out, 1, sizeof(out), file);
+    }
+
+    static const unsigned char padding[ASSET_PACK_ALIGN] = { 0 };
+    long position = PACK_HEADER_SIZE + count*PACK_ENTRY_SIZE;
+    for (int f = 0; f < count; f++) {
+        fwrite(padding, 1, entries[f].offset - position, file);
+        fwrite(blobs[f].data(), 1, blobs[f].size(), file);
+        position = entries[f].offset + entries[f].size;
+    }
+
+    ok = !ferror(file);
+    fclose(file);
+    return ok;
+}
@@ -0,0 +1,34 @@
+/*******************************************************************************************
+*
+*   assetpack - indexed archive of pre-decoded assets, memory mapped at startup
+*
+*   mkpack decodes images to RGBA8 and audio to PCM once, offline, and stores them with
+*   any other file (verbatim) in one archive. The game maps the archive and hands out
+*   pointers into the mapping: no PNG inflate, no WAV parsing and a single file open.
+*
+*   Entries are named by their path relative to the game directory, "./" stripped, so
+*   "./texture/a.png" and "texture/a.png" are the same entry.
+*
+********************************************************************************************/
+
+#ifndef ASSETPACK_H
+#define ASSETPACK_H
+
+#include "raylib.h"
+
+#define ASSET_PACK_PATH         "assets.pak"
+#define ASSET_PACK_VERSION      1
+#define ASSET_PACK_ALIGN        64      // entry data alignment in the file (and the mapping)
+#define ASSET_PACK_NAME_LENGTH  64
+
+bool MountAssetPack(const char *fileName);      // false if missing or damaged, files are used then
+void UnmountAssetPack(void);                    // pointers handed out are invalid afterwards
+
+bool IsAssetPacked(const char *fileName);
+bool GetPackedImage(const char *fileName, Image *image);    // image.data points into the pack, never unload it
+bool GetPackedWave(const char *fileName, Wave *wave);       // same for wave.data
+const unsigned char *GetPackedData(const char *fileName, int *size);   // raw entries, NULL if not packed
+
+bool BuildAssetPack(const char *packPath, const char **files, int count);
+
+#endif // ASSETPACK_H
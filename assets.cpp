@@ -0,0 +1,329 @@
+/*******************************************************************************************
+*
+*   assets - asynchronous texture and sound loading with a refcounted handle cache
+*
+********************************************************************************************/
+
+#include "assets.h"
+#include "assetpack.h"
+#include <condition_variable>
+#include <deque>
+#include <map>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+using namespace std;
+
+enum AssetKind { ASSET_TEXTURE = 0, ASSET_SOUND, ASSET_WAVE, ASSET_KIND_COUNT };
+
+enum AssetState {
+    ASSET_FREE = 0,
+    ASSET_QUEUED,       // waiting for (or in) the decode worker
+    ASSET_DECODED,      // image/wave in RAM, waiting for the upload
+    ASSET_READY,
+    ASSET_FAILED
+};
+
+typedef struct AssetSlot {
+    int kind;
+    int state;
+    int refs;
+    int generation;     // bumped when the slot is freed, stale handles and decodes are ignored
+    bool packed;        // image/wave point into the asset pack, nothing to unload
+    string path;
+    Image image;
+    Wave wave;
+    Texture2D texture;
+    Sound sound;
+} AssetSlot;
+
+// Handle id: slot index + 1 in the low 16 bits, generation above
+#define HANDLE_INDEX_BITS   16
+#define HANDLE_INDEX_MASK   ((1 << HANDLE_INDEX_BITS) - 1)
+
+//----------------------------------------------------------------------------------
+// Global Variables Definition (local)
+//----------------------------------------------------------------------------------
+static vector<AssetSlot> slots;
+static map<string, int> cache[ASSET_KIND_COUNT];   // path -> slot, per AssetKind
+static deque<int> decodeQueue;      // slot index << HANDLE_INDEX_BITS | generation
+static mutex assetsLock;            // guards slot state and the queue, the worker never touches the rest
+static condition_variable queueSignal;
+static thread worker;
+static bool stopping = false;
+
+//----------------------------------------------------------------------------------
+// Module Functions Definitions (local)
+//----------------------------------------------------------------------------------
+static int MakeHandleId(int index)
+{
+    return (slots[index].generation << HANDLE_INDEX_BITS) | (index + 1);
+}
+
+// Slot of a live handle of the given kind, -1 if stale or empty
+static int SlotFromHandle(int id, int kind)
+{
+    int index = (id & HANDLE_INDEX_MASK) - 1;
+    if (index < 0 || index >= (int)slots.size()) return -1;
+
+    const AssetSlot &slot = slots[index];
+    if (slot.state == ASSET_FREE || slot.kind != kind || slot.generation != (id >> HANDLE_INDEX_BITS)) return -1;
+    return index;
+}
+
+static void DecodeWorker(void)
+{
+    unique_lock<mutex> lock(assetsLock);
+
+    for (;;) {
+        queueSignal.wait(lock, [] { return stopping || !decodeQueue.empty(); });
+        if (stopping) return;
+
+        int job = decodeQueue.front();
+        decodeQueue.pop_front();
+        int index = job >> HANDLE_INDEX_BITS;
+        int generation = job & HANDLE_INDEX_MASK;
+        int kind = slots[index].kind;
+        string path = slots[index].path;
+
+        // Decode with the lock released, only CPU work happens here
+        lock.unlock();
+        Image image = { 0 };
+        Wave wave = { 0 };
+        if (kind == ASSET_TEXTURE) image = LoadImage(path.c_str());
+        else wave = LoadWave(path.c_str());
+        if (kind == ASSET_WAVE && wave.data != NULL && wave.sampleSize != 16) WaveFormat(&wave, wave.sampleRate, 16, wave.channels);
+        lock.lock();
+
+        AssetSlot &slot = slots[index];
+        if (slot.generation != generation || slot.state != ASSET_QUEUED) {
+            // Released while decoding
+            if (image.data != NULL) UnloadImage(image);
+            if (wave.data != NULL) UnloadWave(wave);
+            continue;
+        }
+        slot.image = image;
+        slot.wave = wave;
+        if (image.data == NULL && wave.data == NULL) slot.state = ASSET_FAILED;
+        else slot.state = (kind == ASSET_WAVE)? ASSET_READY : ASSET_DECODED;
+    }
+}
+
+static int AcquireSlot(int kind, const char *fileName)
+{
+    lock_guard<mutex> lock(assetsLock);
+
+    map<string, int>::iterator cached = cache[kind].find(fileName);
+    if (cached != cache[kind].end()) {
+        slots[cached->second].refs++;
+        return MakeHandleId(cached->second);
+    }
+
+    int index = 0;
+    while (index < (int)slots.size() && slots[index].state != ASSET_FREE) index++;
+    if (index == HANDLE_INDEX_MASK) return 0;
+    if (index == (int)slots.size()) {
+        AssetSlot empty = { };
+        slots.push_back(empty);
+    }
+
+    AssetSlot &slot = slots[index];
+    slot.kind = kind;
+    slot.state = ASSET_QUEUED;
+    slot.refs = 1;
+    slot.path = fileName;
+    cache[kind][slot.path] = index;
+
+    // Packed assets are decoded already, they go straight to the upload
+    if (kind == ASSET_TEXTURE) slot.packed = GetPackedImage(fileName, &slot.image);
+    else slot.packed = GetPackedWave(fileName, &slot.wave);
+    if (slot.packed) {
+        slot.state = (kind == ASSET_WAVE)? ASSET_READY : ASSET_DECODED;
+        return MakeHandleId(index);
+    }
+
+    decodeQueue.push_back((index << HANDLE_INDEX_BITS) | slot.generation);
+    queueSignal.notify_one();
+
+    return MakeHandleId(index);
+}
+
+static void FreeSlot(int index)
+{
+    AssetSlot &slot = slots[index];
+
+    if (slot.state == ASSET_DECODED && !slot.packed) {
+        if (slot.kind == ASSET_TEXTURE) UnloadImage(slot.image);
+        else UnloadWave(slot.wave);
+    }
+    else if (slot.state == ASSET_READY) {
+        if (slot.kind == ASSET_TEXTURE) UnloadTexture(slot.texture);
+        else if (slot.kind == ASSET_SOUND) UnloadSound(slot.sound);
+        else if (!slot.packed) UnloadWave(slot.wave);
+    }
+
+    cache[slot.kind].erase(slot.path);
+    int generation = (slot.generation + 1) & HANDLE_INDEX_MASK;
+    slot = AssetSlot();
+    slot.generation = generation;
+}
+
+static void ReleaseSlot(int id, int kind)
+{
+    lock_guard<mutex> lock(assetsLock);
+
+    int index = SlotFromHandle(id, kind);
+    if (index < 0) return;
+    if (--slots[index].refs == 0) FreeSlot(index);
+}
+
+//----------------------------------------------------------------------------------
+// Module Functions Definitions
+//----------------------------------------------------------------------------------
+void InitAssets(void)
+{
+    stopping = false;
+    worker = thread(DecodeWorker);
+}
+
+void UnloadAssets(void)
+{
+    {
+        lock_guard<mutex> lock(assetsLock);
+        stopping = true;
+    }
+    queueSignal.notify_all();
+    if (worker.joinable()) worker.join();
+
+    for (int i = 0; i < (int)slots.size(); i++) {
+        if (slots[i].state != ASSET_FREE) FreeSlot(i);
+    }
+    slots.clear();
+    decodeQueue.clear();
+}
+
+// GPU textures and audio buffers can only be created from the thread owning the context
+void UpdateAssets(void)
+{
+    int uploads = 0;
+
+    for (int i = 0; i < (int)slots.size() && uploads < ASSET_UPLOADS_PER_FRAME; i++) {
+        {
+            lock_guard<mutex> lock(assetsLock);
+            if (slots[i].state != ASSET_DECODED) continue;
+        }
+
+        // A decoded slot is only touched again by this thread, upload it unlocked
+        AssetSlot &slot = slots[i];
+        if (slot.kind == ASSET_TEXTURE) {
+            slot.texture = LoadTextureFromImage(slot.image);
+            if (!slot.packed) UnloadImage(slot.image);
+            slot.image = (Image){ 0 };
+        }
+        else {
+            slot.sound = LoadSoundFromWave(slot.wave);
+            if (!slot.packed) UnloadWave(slot.wave);
+            slot.wave = (Wave){ 0 };
+        }
+
+        lock_guard<mutex> lock(assetsLock);
+        slot.state = ASSET_READY;
+        uploads++;
+    }
+}
+
+TextureHandle LoadTextureAsync(const char *fileName)
+{
+    return (TextureHandle){ AcquireSlot(ASSET_TEXTURE, fileName) };
+}
+
+SoundHandle LoadSoundAsync(const char *fileName)
+{
+    return (SoundHandle){ AcquireSlot(ASSET_SOUND, fileName) };
+}
+
+WaveHandle LoadWaveAsync(const char *fileName)
+{
+    return (WaveHandle){ AcquireSlot(ASSET_WAVE, fileName) };
+}
+
+void ReleaseTexture(TextureHandle handle)
+{
+    ReleaseSlot(handle.id, ASSET_TEXTURE);
+}
+
+void ReleaseSound(SoundHandle handle)
+{
+    ReleaseSlot(handle.id, ASSET_SOUND);
+}
+
+void ReleaseWave(WaveHandle handle)
+{
+    ReleaseSlot(handle.id, ASSET_WAVE);
+}
+
+bool IsTextureReady(TextureHandle handle)
+{
+    lock_guard<mutex> lock(assetsLock);
+    int index = SlotFromHandle(handle.id, ASSET_TEXTURE);
+    return index >= 0 && slots[index].state == ASSET_READY;
+}
+
+bool IsSoundReady(SoundHandle handle)
+{
+    lock_guard<mutex> lock(assetsLock);
+    int index = SlotFromHandle(handle.id, ASSET_SOUND);
+    return index >= 0 && slots[index].state == ASSET_READY;
+}
+
+bool IsWaveReady(WaveHandle handle)
+{
+    lock_guard<mutex> lock(assetsLock);
+    int index = SlotFromHandle(handle.id, ASSET_WAVE);
+    return index >= 0 && slots[index].state == ASSET_READY;
+}
+
+Texture2D GetTexture(TextureHandle handle)
+{
+    lock_guard<mutex> lock(assetsLock);
+    int index = SlotFromHandle(handle.id, ASSET_TEXTURE);
+    if (index < 0 || slots[index].state != ASSET_READY) return (Texture2D){ 0 };
+    return slots[index].texture;
+}
+
+Sound GetSound(SoundHandle handle)
+{
+    lock_guard<mutex> lock(assetsLock);
+    int index = SlotFromHandle(handle.id, ASSET_SOUND);
+    if (index < 0 || slots[index].state != ASSET_READY) return (Sound){ 0 };
+    return slots[index].sound;
+}
+
+Wave GetWave(WaveHandle handle)
+{
+    lock_guard<mutex> lock(assetsLock);
+    int index = SlotFromHandle(handle.id, ASSET_WAVE);
+    if (index < 0 || slots[index].state != ASSET_READY) return (Wave){ 0 };
+    return slots[index].wave;
+}
+
+int GetAssetsPending(void)
+{
+    lock_guard<mutex> lock(assetsLock);
+    int pending = 0;
+    for (int i = 0; i < (int)slots.size(); i++) {
+        if (slots[i].state == ASSET_QUEUED || slots[i].state == ASSET_DECODED) pending++;
+    }
+    return pending;
+}
+
+int GetAssetsRequested(void)
+{
+    lock_guard<mutex> lock(assetsLock);
+    int requested = 0;
+    for (int i = 0; i < (int)slots.size(); i++) {
+        if (slots[i].state != ASSET_FREE) requested++;
+    }
+    return requested;
+}
@@ -0,0 +1,51 @@
+/*******************************************************************************************
+*
+*   assets - asynchronous texture and sound loading with a refcounted handle cache
+*
+*   LoadTextureAsync/LoadSoundAsync return a handle at once and queue the file for a worker
+*   thread that decodes it (LoadImage/LoadWave, CPU only). UpdateAssets(), called once per
+*   frame on the main thread, uploads what the worker finished (GPU texture, audio buffer).
+*   LoadWaveAsync keeps the decoded samples in RAM instead, there is nothing to upload.
+*   The same path is loaded once: asking again returns the same handle with one more
+*   reference, and the asset is unloaded when ReleaseTexture/ReleaseSound drop the last.
+*   Assets found in the mounted asset pack (assetpack.h) are decoded already and skip the
+*   worker.
+*
+*   Until an asset is ready, GetTexture/GetSound return an empty one (id 0) that raylib
+*   draws and plays as nothing. Everything here is called from the main thread.
+*
+********************************************************************************************/
+
+#ifndef ASSETS_H
+#define ASSETS_H
+
+#include "raylib.h"
+
+#define ASSET_UPLOADS_PER_FRAME     4       // GPU/audio uploads done by one UpdateAssets()
+
+typedef struct TextureHandle { int id; } TextureHandle;    // id 0: no asset
+typedef struct SoundHandle { int id; } SoundHandle;
+typedef struct WaveHandle { int id; } WaveHandle;          // 16-bit PCM kept in RAM, for the mixer
+
+void InitAssets(void);          // Start the decode worker
+void UnloadAssets(void);        // Stop the worker and unload whatever is still referenced
+void UpdateAssets(void);        // Upload decoded assets (main thread)
+
+TextureHandle LoadTextureAsync(const char *fileName);
+SoundHandle LoadSoundAsync(const char *fileName);
+WaveHandle LoadWaveAsync(const char *fileName);
+void ReleaseTexture(TextureHandle handle);
+void ReleaseSound(SoundHandle handle);
+void ReleaseWave(WaveHandle handle);
+
+bool IsTextureReady(TextureHandle handle);
+bool IsSoundReady(SoundHandle handle);
+bool IsWaveReady(WaveHandle handle);
+Texture2D GetTexture(TextureHandle handle);
+Sound GetSound(SoundHandle handle);
+Wave GetWave(WaveHandle handle);
+
+int GetAssetsPending(void);     // Requested assets not uploaded (or failed) yet
+int GetAssetsRequested(void);
+
+#endif // ASSETS_H
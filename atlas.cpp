@@ -0,0 +1,303 @@
+/*******************************************************************************************
+*
+*   atlas - character sprite sheets packed into one texture, with a table of clips
+*
+*   Clip list (one clip per line, # comments):
+*       clip <name> <sheet> <columns> <rows> <fps> <loop|once> <pivot x> <pivot y>
+*
+*   Atlas table, written by PackSpriteAtlas:
+*       atlas <width> <height>
+*       clip <name> <columns> <rows> <fps> <loop|once> <pivot x> <pivot y>
+*       frame <x> <y> <width> <height>          columns*rows of them, row-major
+*
+********************************************************************************************/
+
+#include "atlas.h"
+#include "assetpack.h"
+#include <math.h>
+#include <stdio.h>
+#include <string.h>
+#include <algorithm>
+#include <string>
+
+#define ATLAS_LINE_LENGTH   512
+#define SHEET_PATH_LENGTH   256
+
+typedef struct SpriteSheet {
+    SpriteClip clip;
+    char path[SHEET_PATH_LENGTH];
+    Image image;
+    int x;              // placement in the atlas
+    int y;
+} SpriteSheet;
+
+//----------------------------------------------------------------------------------
+// Module Functions Definitions (local)
+//----------------------------------------------------------------------------------
+static bool ParseMode(const char *mode, bool *loop)
+{
+    if (strcmp(mode, "loop") == 0) *loop = true;
+    else if (strcmp(mode, "once") == 0) *loop = false;
+    else return false;
+    return true;
+}
+
+static bool ReadClipList(const char *clipsPath, vector<SpriteSheet> &sheets)
+{
+    FILE *file = fopen(clipsPath, "r");
+    if (file == NULL) return false;
+
+    char line[ATLAS_LINE_LENGTH];
+    int lineNumber = 0;
+    bool ok = true;
+    while (ok && fgets(line, sizeof(line), file) != NULL) {
+        lineNumber++;
+        char keyword[16] = { 0 };
+        if (sscanf(line, "%15s", keyword) != 1 || keyword[0] == '#') continue;
+
+        SpriteSheet sheet = { };
+        char mode[8] = { 0 };
+        ok = strcmp(keyword, "clip") == 0 &&
+             sscanf(line, "%*s %31s %255s %d %d %f %7s %f %f", sheet.clip.name, sheet.path, &sheet.clip.columns,
+                    &sheet.clip.rows, &sheet.clip.fps, mode, &sheet.clip.pivot.x, &sheet.clip.pivot.y) == 8 &&
+             sheet.clip.columns > 0 && sheet.clip.rows > 0 && sheet.clip.fps > 0.0f && ParseMode(mode, &sheet.clip.loop);
+        if (ok) sheets.push_back(sheet);
+        else printf("atlas: %s:%d: bad clip\n", clipsPath, lineNumber);
+    }
+
+    fclose(file);
+    return ok && !sheets.empty();
+}
+
+// Table text from the asset pack when it is there, from the file otherwise
+static bool ReadTableText(const char *tablePath, string &text)
+{
+    int size = 0;
+    const unsigned char *packed = GetPackedData(tablePath, &size);
+    if (packed != NULL) {
+        text.assign((const char *)packed, size);
+        return true;
+    }
+
+    FILE *file = fopen(tablePath, "r");
+    if (file == NULL) return false;
+
+    char buffer[ATLAS_LINE_LENGTH];
+    size_t length;
+    text.clear();
+    while ((length = fread(buffer, 1, sizeof(buffer), file)) > 0) text.append(buffer, length);
+    fclose(file);
+    return true;
+}
+
+// Copies the line at *position into line and moves past it, false at the end of the text
+static bool NextLine(const string &text, size_t *position, char *line, size_t lineSize)
+{
+    if (*position >= text.size()) return false;
+
+    size_t end = text.find('\n', *position);
+    if (end == string::npos) end = text.size();
+    size_t length = end - *position;
+    if (length >= lineSize) length = lineSize - 1;
+    memcpy(line, text.data() + *position, length);
+    line[length] = '\0';
+    *position = end + 1;
+    return true;
+}
+
+static bool TallerSheet(const SpriteSheet *a, const SpriteSheet *b)
+{
+    return a->image.height > b->image.height;
+}
+
+// Shelf packing, tallest sheets first; returns the atlas height, 0 if it does not fit
+static int PlaceSheets(vector<SpriteSheet *> &order, int width)
+{
+    int x = 0, y = 0, shelfHeight = 0;
+
+    for (int s = 0; s < (int)order.size(); s++) {
+        SpriteSheet *sheet = order[s];
+        if (sheet->image.width > width) return 0;
+        if (x + sheet->image.width > width) {
+            x = 0;
+            y += shelfHeight + ATLAS_PADDING;
+            shelfHeight = 0;
+        }
+        sheet->x = x;
+        sheet->y = y;
+        x += sheet->image.width + ATLAS_PADDING;
+        if (sheet->image.height > shelfHeight) shelfHeight = sheet->image.height;
+    }
+
+    return y + shelfHeight;
+}
+
+static bool WriteAtlasTable(const char *tablePath, const vector<SpriteSheet> &sheets, int width, int height)
+{
+    FILE *file = fopen(tablePath, "w");
+    if (file == NULL) return false;
+
+    fprintf(file, "atlas %d %d\n", width, height);
+    for (int s = 0; s < (int)sheets.size(); s++) {
+        const SpriteSheet &sheet = sheets[s];
+        const SpriteClip &clip = sheet.clip;
+        fprintf(file, "clip %s %d %d %g %s %g %g\n", clip.name, clip.columns, clip.rows, clip.fps,
+                clip.loop? "loop" : "once", clip.pivot.x, clip.pivot.y);
+
+        // Sheets are cut into an even grid, frames may fall on fractional pixels
+        float frameWidth = (float)sheet.image.width/clip.columns;
+        float frameHeight = (float)sheet.image.height/clip.rows;
+        for (int row = 0; row < clip.rows; row++) {
+            for (int column = 0; column < clip.columns; column++) {
+                fprintf(file, "frame %.3f %.3f %.3f %.3f\n", sheet.x + column*frameWidth, sheet.y + row*frameHeight,
+                        frameWidth, frameHeight);
+            }
+        }
+    }
+
+    bool ok = !ferror(file);
+    fclose(file);
+    return ok;
+}
+
+//----------------------------------------------------------------------------------
+// Module Functions Definitions
+//----------------------------------------------------------------------------------
+bool PackSpriteAtlas(const char *clipsPath, const char *imagePath, const char *tablePath)
+{
+    vector<SpriteSheet> sheets;
+    if (!ReadClipList(clipsPath, sheets)) {
+        printf("atlas: could not read %s\n", clipsPath);
+        return false;
+    }
+
+    bool ok = true;
+    int widest = 0;
+    vector<SpriteSheet *> order;
+    for (int s = 0; s < (int)sheets.size(); s++) {
+        sheets[s].image = LoadImage(sheets[s].path);
+        if (sheets[s].image.data == NULL) {
+            printf("atlas: could not load %s\n", sheets[s].path);
+            ok = false;
+            continue;
+        }
+        ImageFormat(&sheets[s].image, PIXELFORMAT_UNCOMPRESSED_R8G8B8A8);
+        if (sheets[s].image.width > widest) widest = sheets[s].image.width;
+        order.push_back(&sheets[s]);
+    }
+    stable_sort(order.begin(), order.end(), TallerSheet);
+
+    // Smallest power of two width whose packing is no taller than it is wide
+    int width = 64, height = 0;
+    while (width < widest) width *= 2;
+    for (; ok && width <= ATLAS_MAX_SIZE; width *= 2) {
+        height = PlaceSheets(order, width);
+        if (height > 0 && height <= width) break;
+    }
+    if (ok && width > ATLAS_MAX_SIZE) {
+        printf("atlas: sheets do not fit in %dx%d\n", ATLAS_MAX_SIZE, ATLAS_MAX_SIZE);
+        ok = false;
+    }
+
+    if (ok) {
+        int atlasHeight = 64;
+        while (atlasHeight < height) atlasHeight *= 2;
+
+        Image atlas = GenImageColor(width, atlasHeight, BLANK);
+        for (int s = 0; s < (int)order.size(); s++) {
+            const SpriteSheet *sheet = order[s];
+            Rectangle source = { 0.0f, 0.0f, (float)sheet->image.width, (float)sheet->image.height };
+            Rectangle dest = { (float)sheet->x, (float)sheet->y, source.width, source.height };
+            ImageDraw(&atlas, sheet->image, source, dest, WHITE);
+        }
+
+        ok = ExportImage(atlas, imagePath) && WriteAtlasTable(tablePath, sheets, width, atlasHeight);
+        if (ok) printf("atlas: %d clips packed into %s (%dx%d)\n", (int)sheets.size(), imagePath, width, atlasHeight);
+        else printf("atlas: could not write %s or %s\n", imagePath, tablePath);
+        UnloadImage(atlas);
+    }
+
+    for (int s = 0; s < (int)sheets.size(); s++) {
+        if (sheets[s].image.data != NULL) UnloadImage(sheets[s].image);
+    }
+
+    return ok;
+}
+
+bool LoadSpriteAtlas(const char *tablePath, SpriteAtlas *atlas)
+{
+    atlas->width = 0;
+    atlas->height = 0;
+    atlas->clips.clear();
+    atlas->frames.clear();
+
+    string text;
+    if (!ReadTableText(tablePath, text)) return false;
+
+    char line[ATLAS_LINE_LENGTH];
+    size_t position = 0;
+    bool ok = NextLine(text, &position, line, sizeof(line)) &&
+              sscanf(line, "atlas %d %d", &atlas->width, &atlas->height) == 2;
+
+    while (ok && NextLine(text, &position, line, sizeof(line))) {
+        Rectangle frame;
+        SpriteClip clip = { };
+        char mode[8] = { 0 };
+
+        if (sscanf(line, "frame %f %f %f %f", &frame.x, &frame.y, &frame.width, &frame.height) == 4) {
+            ok = !atlas->clips.empty();
+            atlas->frames.push_back(frame);
+        }
+        else {
+            ok = sscanf(line, "clip %31s %d %d %f %7s %f %f", clip.name, &clip.columns, &clip.rows, &clip.fps,
+                        mode, &clip.pivot.x, &clip.pivot.y) == 7 && ParseMode(mode, &clip.loop);
+            clip.firstFrame = (int)atlas->frames.size();
+            atlas->clips.push_back(clip);
+        }
+    }
+
+    // Every clip must come with all of its frames
+    for (int c = 0; ok && c < (int)atlas->clips.size(); c++) {
+        const SpriteClip &clip = atlas->clips[c];
+        int end = (c + 1 < (int)atlas->clips.size())? atlas->clips[c + 1].firstFrame : (int)atlas->frames.size();
+        ok = end - clip.firstFrame == clip.columns*clip.rows;
+    }
+    if (!ok) printf("atlas: %s is damaged\n", tablePath);
+
+    return ok;
+}
+
+bool IsSpriteAtlasStale(const char *clipsPath, const char *imagePath, const char *tablePath)
+{
+    return !FileExists(imagePath) || !FileExists(tablePath) || GetFileModTime(clipsPath) > GetFileModTime(tablePath);
+}
+
+int FindSpriteClip(const SpriteAtlas &atlas, const char *name)
+{
+    for (int c = 0; c < (int)atlas.clips.size(); c++) {
+        if (strcmp(atlas.clips[c].name, name) == 0) return c;
+    }
+    return -1;
+}
+
+int GetSpriteClipFrame(const SpriteAtlas &atlas, int clip, float time)
+{
+    if (clip < 0) return 0;
+
+    const SpriteClip &sprite = atlas.clips[clip];
+    int frame = (int)floorf(time*sprite.fps);
+    if (frame < 0) frame = 0;
+    if (sprite.loop) return frame % sprite.columns;
+    return (frame < sprite.columns)? frame : sprite.columns - 1;
+}
+
+void DrawSpriteClip(Texture2D texture, const SpriteAtlas &atlas, int clip, int row, int frame, Vector2 position, Color tint)
+{
+    if (clip < 0) return;
+
+    const SpriteClip &sprite = atlas.clips[clip];
+    if (row < 0 || row >= sprite.rows) row = 0;
+    Rectangle source = atlas.frames[sprite.firstFrame + row*sprite.columns + frame];
+    Vector2 corner = { position.x - sprite.pivot.x, position.y - sprite.pivot.y };
+    DrawTextureRec(texture, source, corner, tint);
+}
@@ -0,0 +1,52 @@
+/*******************************************************************************************
+*
+*   atlas - character sprite sheets packed into one texture, with a table of clips
+*
+*   PackSpriteAtlas reads the clip list (texture/sprites.txt), shelf-packs every sheet into
+*   one image and writes it out with a table of the frame rectangles of every clip. The
+*   game loads the table and draws every character from the one atlas texture, so bosses
+*   and players go out in the same batch. A new animation is a new line in the clip list.
+*
+********************************************************************************************/
+
+#ifndef ATLAS_H
+#define ATLAS_H
+
+#include "raylib.h"
+#include <vector>
+using namespace std;
+
+#define SPRITE_CLIPS_PATH       "texture/sprites.txt"
+#define ATLAS_IMAGE_PATH        "texture/atlas.png"
+#define ATLAS_TABLE_PATH        "texture/atlas.txt"
+
+#define ATLAS_PADDING           2       // transparent pixels between two sheets
+#define ATLAS_MAX_SIZE          4096
+#define SPRITE_NAME_LENGTH      32
+
+typedef struct SpriteClip {
+    char name[SPRITE_NAME_LENGTH];
+    int columns;        // frames of the animation
+    int rows;           // facings
+    float fps;
+    bool loop;          // otherwise holds the last frame
+    Vector2 pivot;      // drawn this far up and left of the position
+    int firstFrame;     // into SpriteAtlas::frames, row-major
+} SpriteClip;
+
+typedef struct SpriteAtlas {
+    int width;
+    int height;
+    vector<SpriteClip> clips;
+    vector<Rectangle> frames;
+} SpriteAtlas;
+
+bool PackSpriteAtlas(const char *clipsPath, const char *imagePath, const char *tablePath);
+bool LoadSpriteAtlas(const char *tablePath, SpriteAtlas *atlas);
+bool IsSpriteAtlasStale(const char *clipsPath, const char *imagePath, const char *tablePath);   // missing or older than the clip list
+
+int FindSpriteClip(const SpriteAtlas &atlas, const char *name);        // -1 if unknown
+int GetSpriteClipFrame(const SpriteAtlas &atlas, int clip, float time);   // frame shown time seconds into the clip
+void DrawSpriteClip(Texture2D texture, const SpriteAtlas &atlas, int clip, int row, int frame, Vector2 position, Color tint);
+
+#endif // ATLAS_H
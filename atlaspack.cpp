@@ -0,0 +1,30 @@
+/*******************************************************************************************
+*
+*   atlaspack - offline packing of the character sprite atlas
+*
+*   Packs the sheets of the clip list into one image and writes the clip table next to
+*   it. The game does the same on startup when the atlas is missing or out of date, this
+*   is for shipping a prebuilt one.
+*
+*   Usage: atlaspack [clips] [image] [table]
+*          (defaults: texture/sprites.txt texture/atlas.png texture/atlas.txt)
+*
+********************************************************************************************/
+
+#include "atlas.h"
+#include <stdio.h>
+
+int main(int argc, char **argv)
+{
+    if (argc > 4) {
+        printf("usage: atlaspack [clips] [image] [table]\n");
+        return 2;
+    }
+
+    const char *clipsPath = (argc > 1)? argv[1] : SPRITE_CLIPS_PATH;
+    const char *imagePath = (argc > 2)? argv[2] : ATLAS_IMAGE_PATH;
+    const char *tablePath = (argc > 3)? argv[3] : ATLAS_TABLE_PATH;
+
+    SetTraceLogLevel(LOG_WARNING);
+    return PackSpriteAtlas(clipsPath, imagePath, tablePath)? 0 : 1;
+}
@@ -0,0 +1,280 @@
+/*******************************************************************************************
+*
+*   batch - parallel match runner for balancing "Beat the boss!"
+*
+*   Plays M independent matches spread over all cores: every worker owns a World, match m
+*   is seeded with seed + m and driven by an input policy. Results are gathered per match
+*   and reduced in match order, so the report does not depend on the worker count.
+*
+*   Reports the win rate, time to kill (players' wins), damage taken per player and the
+*   throughput. With --sweep the whole batch is repeated for every value of one knob.
+*   batch is never built with the phase timers (make PROFILE=1): their state is not
+*   shared safely between the workers.
+*
+*   Usage: batch [options]
+*
+*       --matches M         matches per configuration (default BATCH_MATCHES)
+*       --threads N         workers, 0 (default) for one per hardware thread
+*       --seed S            seed of the first match (default 1)
+*       --policy P          scripted | aim (default aim)
+*       --skill X           aim policy: chance to act on a tick, 0..1 (default POLICY_DEFAULT_SKILL)
+*       --max-ticks T       a match still running after T ticks is a timeout
+*       --boss-hp X         SimConfig knobs, see world.h
+*       --meteor-speed X
+*       --attack-cycle N
+*       --attack-window N
+*       --volley N
+*       --players N         1 to MAX_PLAYERS, all driven by the policy
+*       --bosses N          1 to MAX_BOSSES
+*       --sweep KNOB=FROM:TO:STEP   repeat the batch over a range of one knob
+*       --csv               one comma separated line per configuration
+*
+********************************************************************************************/
+
+#include "world.h"
+#include "jobs.h"
+#include "policy.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <algorithm>
+#include <chrono>
+#include <vector>
+using namespace std;
+
+#define BATCH_MATCHES       1000
+#define BATCH_MAX_TICKS     (60*60*5)
+
+//----------------------------------------------------------------------------------
+// Types and Structures Definition
+//----------------------------------------------------------------------------------
+struct MatchResult {
+    int winner;             // WINNER_*
+    int ticks;
+    float damageTaken[MAX_PLAYERS];
+};
+
+#define WINNER_NONE         0       // timed out
+#define WINNER_PLAYERS      1
+#define WINNER_BOSS         2
+
+struct BatchReport {
+    int matches;
+    int playerWins;
+    int bossWins;
+    int timeouts;
+    double meanTimeToKill;      // seconds, over the players' wins
+    double medianTimeToKill;
+    double meanDamage[MAX_PLAYERS];
+    double meanTicks;
+    double seconds;
+};
+
+// SimConfig knobs that can be set or swept from the command line, in SetKnob order
+static const char *knobs[] = { "boss-hp", "meteor-speed", "attack-cycle", "attack-window", "volley", "players", "bosses" };
+static const int knobCount = sizeof(knobs)/sizeof(knobs[0]);
+
+//------------------------------------------------------------------------------------
+// Module Functions Definitions
+//------------------------------------------------------------------------------------
+static int FindKnob(const char *name)
+{
+    for (int k = 0; k < knobCount; k++) {
+        if (strcmp(name, knobs[k]) == 0) return k;
+    }
+    return -1;
+}
+
+static void SetKnob(SimConfig *config, int knob, double value)
+{
+    switch (knob) {
+        case 0: config->bossMaxHp = (float)value; break;
+        case 1: config->meteorSpeed = (float)value; break;
+        case 2: config->attackCycle = (int)value; break;
+        case 3: config->attackWindow = (int)value; break;
+        case 4: config->volleyInterval = (int)value; break;
+        case 5: config->playerCount = (int)value; break;
+        case 6: config->bossCount = (int)value; break;
+        default: break;
+    }
+}
+
+static bool ValidConfig(const SimConfig &config)
+{
+    return config.bossMaxHp > 0 && config.meteorSpeed > 0 && config.attackCycle > 0 &&
+           config.attackWindow >= 0 && config.volleyInterval > 0 &&
+           config.playerCount >= 1 && config.playerCount <= MAX_PLAYERS && config.bossCount >= 1 && config.bossCount <= MAX_BOSSES;
+}
+
+static MatchResult PlayMatch(World &world, const SimConfig &config, uint32_t seed, int policy, float skill, int maxTicks)
+{
+    world.config = config;
+    world.init(seed);
+
+    int ticks = 0;
+    while (!world.gameOver && ticks < maxTicks) {
+        world.step(PolicyInput(policy, world, skill));
+        ticks++;
+    }
+
+    MatchResult result;
+    result.ticks = ticks;
+    if (!world.gameOver) result.winner = WINNER_NONE;
+    else result.winner = (world.bosses.size() == 0)? WINNER_PLAYERS : WINNER_BOSS;
+    for (int i = 0; i < world.players.size(); i++) result.damageTaken[i] = PLAYER_MAX_HP - world.players.hp[i];
+    return result;
+}
+
+static BatchReport RunBatch(JobSystem *jobs, vector<World *> &worlds, const SimConfig &config,
+                            int matches, uint32_t seed, int policy, float skill, int maxTicks)
+{
+    vector<MatchResult> results(matches);
+
+    chrono::steady_clock::time_point start = chrono::steady_clock::now();
+    ParallelFor(jobs, matches, 1, [&](int begin, int end, int worker) {
+        for (int m = begin; m < end; m++) results[m] = PlayMatch(*worlds[worker], config, seed + m, policy, skill, maxTicks);
+    });
+
+    BatchReport report;
+    memset(&report, 0, sizeof(report));
+    report.seconds = chrono::duration<double>(chrono::steady_clock::now() - start).count();
+    report.matches = matches;
+
+    vector<float> killTimes;
+    for (int m = 0; m < matches; m++) {
+        const MatchResult &result = results[m];
+        if (result.winner == WINNER_PLAYERS) {
+            report.playerWins++;
+            killTimes.push_back((float)result.ticks/TICK_RATE);
+        }
+        else if (result.winner == WINNER_BOSS) report.bossWins++;
+        else report.timeouts++;
+        for (int i = 0; i < config.playerCount; i++) report.meanDamage[i] += result.damageTaken[i];
+        report.meanTicks += result.ticks;
+    }
+    for (int i = 0; i < config.playerCount; i++) report.meanDamage[i] /= matches;
+    report.meanTicks /= matches;
+
+    if (!killTimes.empty()) {
+        double sum = 0.0;
+        for (int k = 0; k < (int)killTimes.size(); k++) sum += killTimes[k];
+        report.meanTimeToKill = sum/killTimes.size();
+        sort(killTimes.begin(), killTimes.end());
+        report.medianTimeToKill = killTimes[killTimes.size()/2];
+    }
+
+    return report;
+}
+
+// damageColumns: per player columns of the csv header, the rows with fewer players leave theirs empty
+static void PrintReport(const SimConfig &config, const BatchReport &report, bool csv, int damageColumns)
+{
+    double winRate = 100.0*report.playerWins/report.matches;
+    double lossRate = 100.0*report.bossWins/report.matches;
+    double timeoutRate = 100.0*report.timeouts/report.matches;
+
+    if (csv) {
+        printf("%g,%g,%d,%d,%d,%d,%.2f,%.2f,%.2f,%.3f,%.3f", config.bossMaxHp, config.meteorSpeed, config.attackCycle,
+               config.attackWindow, config.volleyInterval, report.matches, winRate, lossRate, timeoutRate,
+               report.meanTimeToKill, report.medianTimeToKill);
+        for (int i = 0; i < damageColumns; i++) {
+            if (i < config.playerCount) printf(",%.2f", report.meanDamage[i]);
+            else printf(",");
+        }
+        printf(",%.1f,%d,%d\n", report.matches/report.seconds, config.playerCount, config.bossCount);
+        return;
+    }
+
+    printf("boss hp %g  meteor speed %g  attack %d/%d  volley %d  players %d  bosses %d\n", config.bossMaxHp, config.meteorSpeed,
+           config.attackWindow, config.attackCycle, config.volleyInterval, config.playerCount, config.bossCount);
+    printf("    players won %5.1f%%  boss won %5.1f%%  timed out %5.1f%%\n", winRate, lossRate, timeoutRate);
+    printf("    time to kill  mean %6.2f s  median %6.2f s   match length %6.2f s\n",
+           report.meanTimeToKill, report.medianTimeToKill, report.meanTicks/TICK_RATE);
+    printf("    damage taken ");
+    for (int i = 0; i < config.playerCount; i++) printf(" player %d %6.1f", i + 1, report.meanDamage[i]);
+    printf("\n    %d matches in %.3f s, %.1f matches/s\n", report.matches, report.seconds, report.matches/report.seconds);
+}
+
+static void Usage(void)
+{
+    printf("usage: batch [--matches M] [--threads N] [--seed S] [--policy scripted|aim] [--skill X]\n"
+           "             [--max-ticks T] [--boss-hp X] [--meteor-speed X] [--attack-cycle N]\n"
+           "             [--attack-window N] [--volley N] [--players N] [--bosses N]\n"
+           "             [--sweep KNOB=FROM:TO:STEP] [--csv]\n");
+}
+
+int main(int argc, char **argv)
+{
+    SimConfig config = defaultSimConfig();
+    int matches = BATCH_MATCHES;
+    int threads = 0;
+    uint32_t seed = 1;
+    int policy = POLICY_AIM;
+    float skill = POLICY_DEFAULT_SKILL;
+    int maxTicks = BATCH_MAX_TICKS;
+    bool csv = false;
+    int sweepKnob = -1;
+    double sweepFrom = 0.0, sweepTo = 0.0, sweepStep = 0.0;
+
+    for (int i = 1; i < argc; i++) {
+        const char *arg = argv[i];
+        const char *value = (i + 1 < argc)? argv[i + 1] : NULL;
+        int knob = (strncmp(arg, "--", 2) == 0)? FindKnob(arg + 2) : -1;
+
+        if (strcmp(arg, "--csv") == 0) csv = true;
+        else if (value == NULL) { Usage(); return 2; }
+        else if (strcmp(arg, "--matches") == 0) { matches = atoi(value); i++; }
+        else if (strcmp(arg, "--threads") == 0) { threads = atoi(value); i++; }
+        else if (strcmp(arg, "--seed") == 0) { seed = (uint32_t)strtoul(value, NULL, 10); i++; }
+        else if (strcmp(arg, "--max-ticks") == 0) { maxTicks = atoi(value); i++; }
+        else if (strcmp(arg, "--skill") == 0) { skill = (float)atof(value); i++; }
+        else if (strcmp(arg, "--policy") == 0) {
+            policy = PolicyFromName(value);
+            if (policy < 0) { Usage(); return 2; }
+            i++;
+        }
+        else if (knob >= 0) { SetKnob(&config, knob, atof(value)); i++; }
+        else if (strcmp(arg, "--sweep") == 0) {
+            char name[32] = { 0 };
+            if (sscanf(value, "%31[^=]=%lf:%lf:%lf", name, &sweepFrom, &sweepTo, &sweepStep) != 4 ||
+                (sweepKnob = FindKnob(name)) < 0 || sweepStep <= 0.0) { Usage(); return 2; }
+            i++;
+        }
+        else { Usage(); return 2; }
+    }
+    if (matches < 1 || maxTicks < 1 || !ValidConfig(config)) { Usage(); return 2; }
+
+    JobSystem jobs(threads);
+    vector<World *> worlds(jobs.workerCount());
+    for (int w = 0; w < jobs.workerCount(); w++) {
+        worlds[w] = new World();
+        worlds[w]->verbose = false;
+    }
+
+    int damageColumns = config.playerCount;
+    if (sweepKnob >= 0 && sweepKnob == FindKnob("players")) damageColumns = (int)max(sweepFrom, sweepTo);
+    damageColumns = max(1, min(damageColumns, MAX_PLAYERS));
+
+    if (csv) {
+        printf("boss_hp,meteor_speed,attack_cycle,attack_window,volley,matches,player_win_pct,boss_win_pct,timeout_pct,"
+               "ttk_mean_s,ttk_median_s");
+        for (int i = 0; i < damageColumns; i++) printf(",damage_p%d", i + 1);
+        printf(",matches_per_s,players,bosses\n");
+    }
+    else printf("%d workers, policy %s (skill %.2f), %d matches per configuration from seed %u\n\n",
+                jobs.workerCount(), PolicyName(policy), skill, matches, seed);
+
+    int steps = (sweepKnob >= 0)? (int)((sweepTo - sweepFrom)/sweepStep + 1e-6) + 1 : 1;
+    for (int s = 0; s < steps; s++) {
+        if (sweepKnob >= 0) SetKnob(&config, sweepKnob, sweepFrom + s*sweepStep);
+        if (!ValidConfig(config)) continue;
+
+        BatchReport report = RunBatch(&jobs, worlds, config, matches, seed, policy, skill, maxTicks);
+        PrintReport(config, report, csv, damageColumns);
+        if (!csv && s + 1 < steps) printf("\n");
+    }
+
+    for (int w = 0; w < (int)worlds.size(); w++) delete worlds[w];
+
+    return 0;
+}
@@ -0,0 +1,586 @@
+/*******************************************************************************************
+*
+*   bench - scripted stress scenarios for the "Beat the boss!" simulation core
+*
+*   Every scenario is a fixed seed, a fixed setup of the World and a scripted input, so
+*   two runs on the same machine do the same work. Except in longrun, players and bosses
+*   are held at their scenario HP between ticks so the load never changes shape mid run.
+*
+*       bosses      BENCH_BOSSES bosses chasing the players
+*       crowd       a match set up with BENCH_CROWD_PLAYERS players against
+*                   BENCH_CROWD_BOSSES bosses, every player on the scripted input
+*       burst       BENCH_BURST_BOSSES bosses below a third of their HP, so every volley is
+*                   the radial burst; players hold fire to keep them alive
+*       drift       BENCH_DRIFT meteors drifting with nobody firing: the 10000 projectiles the
+*                   50 us snapshot capture target is set for (not met yet), see --snapshot
+*       fire        both players firing every tick into a field of BENCH_FIELD meteors
+*       longrun     ordinary matches back to back, BENCH_LONGRUN_SCALE times more ticks
+*       pattern     BENCH_PATTERN_BOSSES bosses firing the dense hellPatterns table: spinning
+*                   spirals and aimed fans, a few thousand meteors spawned per second
+*       swarm       MAX_BOSSES bosses and a field of BENCH_SWARM meteors under fire every
+*                   tick, big enough for every phase to be split across job workers
+*
+*   Reports ticks/s, ns per entity for every phase (from the profiler timers, which the
+*   bench build always has) and the peak resident memory, on stdout and as JSON. Every
+*   scenario runs in a child process of its own, so its peak is not an earlier one's.
+*
+*   Usage: bench [--ticks N] [--threads N] [--audio] [--snapshot] [--log] [--json file] [scenario ...]
+*
+*       --threads N     step with a job system of N workers (0: one per hardware thread);
+*                       the checksum of every scenario must not depend on it
+*       --audio         also play every tick's sound events through the mixer into a null
+*                       output (synthetic samples), timed as the audio phase
+*       --snapshot      also capture every tick into a snapshot ring of BENCH_SNAPSHOT_RING
+*                       ticks, reported as time and bytes per snapshot
+*       --log           also time BENCH_LOG_CALLS debug log calls like the World's traces:
+*                       compiled out, filtered by the runtime level, enabled (into the ring,
+*                       drained to /dev/null by the log thread) and a plain fprintf for scale
+*
+********************************************************************************************/
+
+#include "world.h"
+#include "profiler.h"
+#include "jobs.h"
+#include "mixer.h"
+#include "sfx.h"
+#include "snapshot.h"
+#include "log.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <chrono>
+#include <sys/resource.h>
+#include <sys/wait.h>
+#include <unistd.h>
+using namespace std;
+
+#define BENCH_SEED          1
+#define BENCH_WARMUP        600         // ticks run before the timers are reset
+#define BENCH_TICKS         20000       // measured ticks per scenario
+#define BENCH_LONGRUN_SCALE 10
+#define BENCH_SWARM_SCALE   50          // swarm runs this many times fewer ticks
+
+#define BENCH_BOSSES        32
+#define BENCH_BURST_BOSSES  16
+#define BENCH_FIELD         2000        // meteors kept on screen in the fire scenario
+#define BENCH_DRIFT         10000       // meteors kept on screen in the drift scenario
+#define BENCH_SWARM         100000      // meteors kept on screen in the swarm scenario
+#define BENCH_PATTERN_BOSSES 16
+#define BENCH_CROWD_PLAYERS 8
+#define BENCH_CROWD_BOSSES  16
+#define BENCH_UNKILLABLE    1.0e9f      // HP no single tick of damage can take away
+#define BENCH_SNAPSHOT_RING (2*SNAPSHOT_KEYFRAME_TICKS)     // the swarm images are megabytes each
+#define BENCH_LOG_CALLS     (1 << 20)
+#define BENCH_LOG_BURST     (LOG_RING_RECORDS/2)    // enabled calls timed between flushes, the ring never fills
+
+// Synthetic stand-ins for the sound effects: a mono shot at half rate (resampled) and a
+// longer stereo volley at the mixer rate
+#define BENCH_SHOT_RATE     22050
+#define BENCH_SHOT_SECONDS  0.25f
+#define BENCH_VOLLEY_SECONDS 0.8f
+
+// Player fire in the scripted input
+#define FIRE_NONE           0
+#define FIRE_SCRIPTED       1           // every sixth tick, like soak
+#define FIRE_EVERY_TICK     2
+
+//----------------------------------------------------------------------------------
+// Types and Structures Definition
+//----------------------------------------------------------------------------------
+struct Scenario {
+    const char *name;
+    int tickScale;          // > 0 multiplies the tick count, < 0 divides it
+    void (*setup)(World &world);
+    void (*beforeStep)(World &world, Rng &rng);   // pin HP, top up the field...
+    int fire;
+    bool restarts;          // a finished match restarts instead of spoiling the run
+};
+
+// Sums of the per tick entity counts, so averages and per entity costs come out of it
+struct EntityTicks {
+    double bosses;
+    double players;
+    double meteors;
+    double bullets;
+    double voices;
+};
+
+struct ScenarioResult {
+    const char *name;
+    int ticks;
+    double seconds;
+    EntityTicks entities;
+    double phaseUs[PHASE_COUNT];
+    double phaseNsPerEntity[PHASE_COUNT];
+    int matches;
+    uint32_t checksum;      // world state at the end, to compare builds and worker counts
+    long peakRssKb;
+    bool audio;
+    MixerStats mixer;
+    bool snapshot;
+    double snapshotUs;      // total capture time
+    SnapshotStats snapshots;
+};
+
+// Nanoseconds per log call on the game thread
+struct LogBenchResult {
+    double compiledOut;     // LOGT, below LOG_MIN_LEVEL
+    double levelOff;        // LOGD with the runtime level at info
+    double enabled;         // LOGD into the ring
+    double direct;          // fprintf of the same line
+    long dropped;
+};
+
+static vector<short> shotSamples;
+static vector<short> volleySamples;
+
+//------------------------------------------------------------------------------------
+// Scenarios
+//------------------------------------------------------------------------------------
+static void AddBosses(World &world, int count, float hp)
+{
+    world.bosses.clear();
+    for (int i = 0; i < count; i++) {
+        // Spread them over a ring around the screen center
+        float angle = 360.0f*i/count;
+        Vector2 position;
+        position.x = screenWidth/2 + sinf(angle*DEG2RAD)*screenWidth/3;
+        position.y = screenHeight/2 - cosf(angle*DEG2RAD)*screenHeight/3;
+        world.spawnBoss(position, hp);
+    }
+}
+
+static void PinPlayers(World &world)
+{
+    for (int i = 0; i < world.players.size(); i++) world.players.hp[i] = BENCH_UNKILLABLE;
+}
+
+static void SetupBosses(World &world) { AddBosses(world, BENCH_BOSSES, BENCH_UNKILLABLE); }
+static void SetupBurst(World &world) { AddBosses(world, BENCH_BURST_BOSSES, world.config.bossMaxHp/3 - 1); }
+static void SetupSwarm(World &world) { AddBosses(world, MAX_BOSSES, BENCH_UNKILLABLE); }
+static void SetupMatch(World &world) { }
+
+static void SetupCrowd(World &world)
+{
+    world.config.playerCount = BENCH_CROWD_PLAYERS;
+    world.config.bossCount = BENCH_CROWD_BOSSES;
+    world.init(BENCH_SEED);
+}
+
+// Two spirals turning opposite ways and an aimed fan, over the whole HP range
+static const PatternDesc hellPatterns[] = {
+    { "spiral",  0, 1, 1,  5, 0, 24,   0.0f, 15.0f,  7.0f, 1.0f,  6.0f, 0, 0.0f, RED,       10, AIM_FIXED,  0 },
+    { "counter", 0, 1, 1,  5, 2, 24,   7.5f, 15.0f, -7.0f, 1.5f,  6.0f, 0, 0.0f, MAROON,    10, AIM_FIXED,  0 },
+    { "fan",     0, 1, 1, 10, 0,  7, -15.0f,  5.0f,  0.0f, 2.0f,  8.0f, 0, 0.0f, YELLOW,    10, AIM_PLAYER, 20 },
+};
+
+static void SetupPattern(World &world)
+{
+    AddBosses(world, BENCH_PATTERN_BOSSES, BENCH_UNKILLABLE);
+    world.setPatterns(hellPatterns, sizeof(hellPatterns)/sizeof(hellPatterns[0]));
+}
+
+// Far above a third of the boss max HP, so volleys stay aimed
+static void HoldHighHp(World &world, Rng &rng)
+{
+    PinPlayers(world);
+    for (int i = 0; i < world.bosses.size(); i++) world.bosses.hp[i] = BENCH_UNKILLABLE;
+}
+
+static void HoldLowHp(World &world, Rng &rng)
+{
+    PinPlayers(world);
+    for (int i = 0; i < world.bosses.size(); i++) world.bosses.hp[i] = world.config.bossMaxHp/3 - 1;
+}
+
+static void NoPin(World &world, Rng &rng) { }
+
+static void TopUpMeteors(World &world, Rng &rng, int count)
+{
+    HoldHighHp(world, rng);
+    while (world.meteors.size() < count) {
+        float x = (float)rng.nextInt(screenWidth);
+        float y = (float)rng.nextInt(screenHeight);
+        float vx = (rng.nextInt(201) - 100)/100.0f;
+        float vy = (rng.nextInt(201) - 100)/100.0f;
+        world.meteors.spawn(x, y, vx, vy, rng.nextInt(2)? 20 : 10, GRAY, 10);
+    }
+}
+
+static void TopUpField(World &world, Rng &rng) { TopUpMeteors(world, rng, BENCH_FIELD); }
+static void TopUpDrift(World &world, Rng &rng) { TopUpMeteors(world, rng, BENCH_DRIFT); }
+static void TopUpSwarm(World &world, Rng &rng) { TopUpMeteors(world, rng, BENCH_SWARM); }
+
+static const Scenario scenarios[] = {
+    { "bosses",  1,                   SetupBosses, HoldHighHp, FIRE_SCRIPTED,   false },
+    { "burst",   1,                   SetupBurst,  HoldLowHp,  FIRE_NONE,       false },
+    { "crowd",   1,                   SetupCrowd,  HoldHighHp, FIRE_SCRIPTED,   false },
+    { "drift",   1,                   SetupMatch,  TopUpDrift, FIRE_NONE,       false },
+    { "fire",    1,                   SetupMatch,  TopUpField, FIRE_EVERY_TICK, false },
+    { "longrun", BENCH_LONGRUN_SCALE, SetupMatch,  NoPin,      FIRE_SCRIPTED,   true },
+    { "pattern", 1,                   SetupPattern, HoldHighHp, FIRE_SCRIPTED,  false },
+    { "swarm",   -BENCH_SWARM_SCALE,  SetupSwarm,  TopUpSwarm, FIRE_EVERY_TICK, false },
+};
+static const int scenarioCount = sizeof(scenarios)/sizeof(scenarios[0]);
+
+// Same wandering as soak, restart as soon as a match is over
+static InputFrame ScriptedInput(const World &world, int fire)
+{
+    InputFrame input = { };
+
+    for (int i = 0; i < world.players.size(); i++) {
+        int phase = (world.framesCounter / 40 + i) % 4;
+        input.player[i] = (unsigned char)(1 << phase);
+        if (fire == FIRE_EVERY_TICK || (fire == FIRE_SCRIPTED && (world.framesCounter + i*3) % 6 == 0)) input.player[i] |= INPUT_FIRE;
+    }
+    if (world.gameOver) input.system = INPUT_RESTART;
+
+    return input;
+}
+
+//------------------------------------------------------------------------------------
+// Runner
+//------------------------------------------------------------------------------------
+static void MakeTone(vector<short> &samples, int rate, int channels, float seconds, float frequency)
+{
+    int frames = (int)(rate*seconds);
+    samples.resize(frames*channels);
+    for (int f = 0; f < frames; f++) {
+        float fade = 1.0f - (float)f/frames;
+        short value = (short)(sinf(2.0f*PI*frequency*f/rate)*12000.0f*fade);
+        for (int c = 0; c < channels; c++) samples[f*channels + c] = value;
+    }
+}
+
+static void InitBenchMixer(Mixer &mixer)
+{
+    if (shotSamples.empty()) {
+        MakeTone(shotSamples, BENCH_SHOT_RATE, 1, BENCH_SHOT_SECONDS, 880.0f);
+        MakeTone(volleySamples, MIXER_SAMPLE_RATE, 2, BENCH_VOLLEY_SECONDS, 110.0f);
+    }
+
+    MixerSound shot = { shotSamples.data(), (int)shotSamples.size(), 1, BENCH_SHOT_RATE };
+    MixerSound volley = { volleySamples.data(), (int)volleySamples.size()/2, 2, MIXER_SAMPLE_RATE };
+    mixer.addSound(shot);
+    mixer.addSound(volley);
+    for (int i = 0; i < SFX_COUNT; i++) mixer.addEvent(sfxEvents[i]);
+}
+
+static long PeakRssKb(void)
+{
+    struct rusage usage;
+    getrusage(RUSAGE_SELF, &usage);
+    return usage.ru_maxrss;     // kilobytes on Linux
+}
+
+static ScenarioResult RunScenario(const Scenario &scenario, int ticks, JobSystem *jobs, bool audio, bool snapshot)
+{
+    ScenarioResult result;
+    memset(&result, 0, sizeof(result));
+    result.name = scenario.name;
+    result.ticks = (scenario.tickScale > 0)? ticks*scenario.tickScale : ticks/(-scenario.tickScale);
+    if (result.ticks < 1) result.ticks = 1;
+
+    World *world = new World();
+    world->verbose = false;
+    world->setJobSystem(jobs);
+    world->init(BENCH_SEED);
+    scenario.setup(*world);
+
+    Rng rng;
+    rng.seed(BENCH_SEED);
+
+    Mixer *mixer = new Mixer();     // idle unless --audio
+    NullAudioOutput output(mixer);
+    InitBenchMixer(*mixer);
+
+    SnapshotRing *ring = snapshot? new SnapshotRing(BENCH_SNAPSHOT_RING) : NULL;
+
+    for (int t = 0; t < BENCH_WARMUP; t++) {
+        scenario.beforeStep(*world, rng);
+        world->step(ScriptedInput(*world, scenario.fire));
+    }
+
+    ProfilerReset();
+    result.matches = 1;
+    chrono::steady_clock::time_point start = chrono::steady_clock::now();
+    for (int t = 0; t < result.ticks; t++) {
+        scenario.beforeStep(*world, rng);
+        bool over = world->gameOver;
+        world->step(ScriptedInput(*world, scenario.fire));
+        if (over && !world->gameOver) result.matches++;
+
+        if (audio) {
+            PROFILE_BEGIN(PHASE_AUDIO);
+            for (int i = 0; i < world->events.playerShots; i++) mixer->trigger(SFX_PLAYER_SHOT);
+            for (int i = 0; i < world->events.bossVolleys; i++) mixer->trigger(SFX_BOSS_VOLLEY);
+            mixer->update(t*TICK_DT);
+            output.advance(TICK_DT);
+            PROFILE_END(PHASE_AUDIO);
+            result.entities.voices += mixer->activeVoices();
+        }
+
+        if (ring != NULL) {
+            chrono::steady_clock::time_point captureStart = chrono::steady_clock::now();
+            ring->capture(*world);
+            result.snapshotUs += chrono::duration<double, micro>(chrono::steady_clock::now() - captureStart).count();
+        }
+
+        result.entities.bosses += world->bosses.size();
+        result.entities.players += world->players.size();
+        result.entities.meteors += world->meteors.size();
+        result.entities.bullets += world->playerBullets.size() + world->bossBullets.size();
+    }
+    result.seconds = chrono::duration<double>(chrono::steady_clock::now() - start).count();
+
+    if (!scenario.restarts && result.matches > 1) printf("bench: scenario %s ended the match, results are not comparable\n", scenario.name);
+
+    // Every phase is charged to the entities it walks; collision walks all of them
+    const EntityTicks &e = result.entities;
+    double perPhase[PHASE_COUNT] = { e.bosses, e.players, e.bullets, e.meteors,
+                                     e.bosses + e.players + e.meteors + e.bullets, e.voices, 0.0 };
+    for (int phase = 0; phase < PHASE_COUNT; phase++) {
+        result.phaseUs[phase] = ProfilerGetTotal(phase);
+        result.phaseNsPerEntity[phase] = (perPhase[phase] > 0.0)? result.phaseUs[phase]*1000.0/perPhase[phase] : 0.0;
+    }
+
+    result.checksum = world->checksum();
+    result.audio = audio;
+    result.mixer = mixer->stats;
+    result.snapshot = snapshot;
+    if (ring != NULL) result.snapshots = ring->stats;
+    delete ring;
+    delete mixer;
+    delete world;
+    result.peakRssKb = PeakRssKb();
+    return result;
+}
+
+// RunScenario() in a forked child, which starts with the (small) resident set of the bench
+// at fork time instead of the high-water mark of the scenarios before. The child makes its
+// own job system: the workers of the parent do not exist in it
+static bool RunScenarioIsolated(const Scenario &scenario, int ticks, int threads, bool audio, bool snapshot, ScenarioResult *result)
+{
+    int fds[2];
+    if (pipe(fds) != 0) return false;
+
+    fflush(stdout);
+    pid_t child = fork();
+    if (child < 0) {
+        close(fds[0]);
+        close(fds[1]);
+        return false;
+    }
+
+    if (child == 0) {
+        close(fds[0]);
+        JobSystem *jobs = (threads >= 0)? new JobSystem(threads) : NULL;
+        ScenarioResult childResult = RunScenario(scenario, ticks, jobs, audio, snapshot);
+        delete jobs;
+
+        const char *data = (const char *)&childResult;
+        size_t written = 0;
+        while (written < sizeof(childResult)) {
+            ssize_t n = write(fds[1], data + written, sizeof(childResult) - written);
+            if (n <= 0) _exit(1);
+            written += (size_t)n;
+        }
+        _exit(0);
+    }
+
+    close(fds[1]);
+    char *data = (char *)result;
+    size_t got = 0;
+    while (got < sizeof(*result)) {
+        ssize_t n = read(fds[0], data + got, sizeof(*result) - got);
+        if (n <= 0) break;
+        got += (size_t)n;
+    }
+    close(fds[0]);
+
+    int status = 0;
+    waitpid(child, &status, 0);
+    return got == sizeof(*result) && WIFEXITED(status) && WEXITSTATUS(status) == 0;
+}
+
+// The hot path traces of the World look like this one: a couple of ints and a name
+static LogBenchResult RunLogBench(void)
+{
+    LogBenchResult result = { };
+    FILE *sink = fopen("/dev/null", "w");
+    if (sink == NULL) sink = tmpfile();
+    volatile int sideEffect = 0;
+
+    chrono::steady_clock::time_point start = chrono::steady_clock::now();
+    for (int i = 0; i < BENCH_LOG_CALLS; i++) {
+        LOGT("boss %d volley %s: %d meteors\n", i & 63, "radial", 19);
+        sideEffect = i;
+    }
+    result.compiledOut = chrono::duration<double, nano>(chrono::steady_clock::now() - start).count()/BENCH_LOG_CALLS;
+
+    LogStart(sink);
+    int level = logLevel;
+    LogSetLevel(LOGLEVEL_INFO);
+    start = chrono::steady_clock::now();
+    for (int i = 0; i < BENCH_LOG_CALLS; i++) {
+        LOGD("boss %d volley %s: %d meteors\n", i & 63, "radial", 19);
+        sideEffect = i;
+    }
+    result.levelOff = chrono::duration<double, nano>(chrono::steady_clock::now() - start).count()/BENCH_LOG_CALLS;
+
+    LogSetLevel(LOGLEVEL_DEBUG);
+    double enabledNs = 0.0;
+    for (int i = 0; i < BENCH_LOG_CALLS; ) {
+        start = chrono::steady_clock::now();
+        for (int k = 0; k < BENCH_LOG_BURST; k++, i++) LOGD("boss %d volley %s: %d meteors\n", i & 63, "radial", 19);
+        enabledNs += chrono::duration<double, nano>(chrono::steady_clock::now() - start).count();
+        LogFlush();
+    }
+    result.enabled = enabledNs/BENCH_LOG_CALLS;
+    LogStop();
+    LogSetLevel(level);
+    result.dropped = LogDropped();
+
+    start = chrono::steady_clock::now();
+    for (int i = 0; i < BENCH_LOG_CALLS; i++) fprintf(sink, "boss %d volley %s: %d meteors\n", i & 63, "radial", 19);
+    fflush(sink);
+    result.direct = chrono::duration<double, nano>(chrono::steady_clock::now() - start).count()/BENCH_LOG_CALLS;
+
+    fclose(sink);
+    (void)sideEffect;
+    return result;
+}
+
+static void PrintLogResult(const LogBenchResult &result)
+{
+    printf("log          compiled out %6.2f ns/call   level off %6.2f ns/call   enabled %6.2f ns/call   fprintf %6.2f ns/call   dropped %ld\n",
+           result.compiledOut, result.levelOff, result.enabled, result.direct, result.dropped);
+}
+
+static void PrintResult(const ScenarioResult &result)
+{
+    printf("%-8s %7d ticks %8.3f s %10.0f ticks/s  %4d matches   avg bosses %.1f meteors %.1f bullets %.1f   peak rss %ld kB   checksum %08x\n",
+           result.name, result.ticks, result.seconds, result.ticks/result.seconds, result.matches,
+           result.entities.bosses/result.ticks, result.entities.meteors/result.ticks,
+           result.entities.bullets/result.ticks, result.peakRssKb, result.checksum);
+    for (int phase = 0; phase < PHASE_DRAW; phase++) {
+        if (phase == PHASE_AUDIO && !result.audio) continue;
+        printf("         %-10s %10.1f us  %8.2f ns/entity\n", ProfilerPhaseName(phase), result.phaseUs[phase], result.phaseNsPerEntity[phase]);
+    }
+    if (result.audio) {
+        const MixerStats &m = result.mixer;
+        printf("         sound events %ld: played %ld, coalesced %ld, rate limited %ld, stolen %ld, dropped %ld, avg voices %.2f\n",
+               m.triggered, m.played, m.coalesced, m.rateLimited, m.stolen, m.dropped, result.entities.voices/result.ticks);
+    }
+    if (result.snapshot) {
+        const SnapshotStats &st = result.snapshots;
+        printf("         snapshot   %10.2f us/tick  image %.1f kB, stored %.1f kB (%ld keyframes)\n", result.snapshotUs/st.captures,
+               st.bytesIn/1024.0/st.captures, st.bytesOut/1024.0/st.captures, st.keyframes);
+    }
+}
+
+static bool WriteJson(const char *fileName, const ScenarioResult *results, int count, int workers, const LogBenchResult *log)
+{
+    FILE *file = fopen(fileName, "w");
+    if (file == NULL) return false;
+
+    fprintf(file, "{\n  \"seed\": %d,\n  \"warmup\": %d,\n  \"workers\": %d,\n  \"scenarios\": [\n", BENCH_SEED, BENCH_WARMUP, workers);
+    for (int i = 0; i < count; i++) {
+        const ScenarioResult &r = results[i];
+        fprintf(file, "    {\"name\": \"%s\", \"ticks\": %d, \"seconds\": %.6f, \"ticks_per_sec\": %.1f, \"matches\": %d, \"checksum\": \"%08x\", \"peak_rss_kb\": %ld,\n",
+                r.name, r.ticks, r.seconds, r.ticks/r.seconds, r.matches, r.checksum, r.peakRssKb);
+        fprintf(file, "     \"avg_entities\": {\"bosses\": %.2f, \"players\": %.2f, \"meteors\": %.2f, \"bullets\": %.2f},\n",
+                r.entities.bosses/r.ticks, r.entities.players/r.ticks, r.entities.meteors/r.ticks, r.entities.bullets/r.ticks);
+        fprintf(file, "     \"phases\": {");
+        for (int phase = 0; phase < PHASE_DRAW; phase++) {
+            fprintf(file, "%s\"%s\": {\"total_us\": %.1f, \"ns_per_entity\": %.3f}", (phase > 0)? ", " : "",
+                    ProfilerPhaseName(phase), r.phaseUs[phase], r.phaseNsPerEntity[phase]);
+        }
+        fprintf(file, "}");
+        if (r.audio) {
+            fprintf(file, ",\n     \"sound_events\": {\"triggered\": %ld, \"played\": %ld, \"coalesced\": %ld, \"rate_limited\": %ld, \"stolen\": %ld, \"dropped\": %ld, \"avg_voices\": %.3f}",
+                    r.mixer.triggered, r.mixer.played, r.mixer.coalesced, r.mixer.rateLimited, r.mixer.stolen, r.mixer.dropped, r.entities.voices/r.ticks);
+        }
+        if (r.snapshot) {
+            fprintf(file, ",\n     \"snapshot\": {\"us_per_tick\": %.3f, \"image_bytes\": %.1f, \"stored_bytes\": %.1f, \"keyframes\": %ld}",
+                    r.snapshotUs/r.snapshots.captures, (double)r.snapshots.bytesIn/r.snapshots.captures,
+                    (double)r.snapshots.bytesOut/r.snapshots.captures, r.snapshots.keyframes);
+        }
+        fprintf(file, "}%s\n", (i + 1 < count)? "," : "");
+    }
+    fprintf(file, "  ]");
+    if (log != NULL) {
+        fprintf(file, ",\n  \"log\": {\"compiled_out_ns\": %.3f, \"level_off_ns\": %.3f, \"enabled_ns\": %.3f, \"fprintf_ns\": %.3f, \"dropped\": %ld}",
+                log->compiledOut, log->levelOff, log->enabled, log->direct, log->dropped);
+    }
+    fprintf(file, "\n}\n");
+
+    fclose(file);
+    return true;
+}
+
+int main(int argc, char **argv)
+{
+    int ticks = BENCH_TICKS;
+    int threads = -1;
+    bool audio = false;
+    bool snapshot = false;
+    bool logBench = false;
+    const char *jsonPath = "bench.json";
+    bool selected[scenarioCount] = { };
+    bool anySelected = false;
+
+    for (int i = 1; i < argc; i++) {
+        if (strcmp(argv[i], "--ticks") == 0 && i + 1 < argc) ticks = atoi(argv[++i]);
+        else if (strcmp(argv[i], "--threads") == 0 && i + 1 < argc) threads = atoi(argv[++i]);
+        else if (strcmp(argv[i], "--json") == 0 && i + 1 < argc) jsonPath = argv[++i];
+        else if (strcmp(argv[i], "--audio") == 0) audio = true;
+        else if (strcmp(argv[i], "--snapshot") == 0) snapshot = true;
+        else if (strcmp(argv[i], "--log") == 0) logBench = true;
+        else {
+            int s = 0;
+            while (s < scenarioCount && strcmp(argv[i], scenarios[s].name) != 0) s++;
+            if (s == scenarioCount) {
+                printf("usage: bench [--ticks N] [--threads N] [--audio] [--snapshot] [--log] [--json file] [bosses|burst|crowd|drift|fire|longrun|pattern|swarm ...]\n");
+                return 2;
+            }
+            selected[s] = true;
+            anySelected = true;
+        }
+    }
+    if (ticks < 1) ticks = 1;
+
+    // Scenarios make their own in their process, this one is only asked how many workers
+    JobSystem *jobs = (threads >= 0)? new JobSystem(threads) : NULL;
+    int workers = jobs? jobs->workerCount() : 1;
+    delete jobs;
+    printf("workers: %d\n", workers);
+
+    ProfilerEnableTrace(false);     // only the totals are needed, keep the trace buffer out of the RSS
+
+    ScenarioResult results[scenarioCount];
+    int count = 0;
+    for (int s = 0; s < scenarioCount; s++) {
+        if (anySelected && !selected[s]) continue;
+        if (!RunScenarioIsolated(scenarios[s], ticks, threads, audio, snapshot, &results[count])) {
+            printf("bench: scenario %s failed\n", scenarios[s].name);
+            return 1;
+        }
+        PrintResult(results[count]);
+        count++;
+    }
+
+    LogBenchResult log = { };
+    if (logBench) {
+        log = RunLogBench();
+        PrintLogResult(log);
+    }
+
+    if (!WriteJson(jsonPath, results, count, workers, logBench? &log : NULL)) {
+        printf("bench: could not write %s\n", jsonPath);
+        return 1;
+    }
+    printf("results written to %s\n", jsonPath);
+
+    return 0;
+}
@@ -0,0 +1,88 @@
+/*******************************************************************************************
+*
+*   circlebatch - batched drawing of meteors and bullets
+*
+********************************************************************************************/
+
+#include "circlebatch.h"
+#include "rlgl.h"
+#include <math.h>
+#include <stdlib.h>
+
+static Texture2D circleSprite = { 0 };
+
+// White disc with a one pixel anti-aliased rim, alpha carries the coverage
+void InitCircleBatch(void)
+{
+    int size = CIRCLE_SPRITE_SIZE;
+    Color *pixels = (Color *)malloc(size*size*sizeof(Color));
+    float center = size/2.0f;
+
+    for (int y = 0; y < size; y++) {
+        for (int x = 0; x < size; x++) {
+            float dx = x + 0.5f - center;
+            float dy = y + 0.5f - center;
+            float coverage = center - sqrtf(dx*dx + dy*dy);
+            if (coverage < 0.0f) coverage = 0.0f;
+            if (coverage > 1.0f) coverage = 1.0f;
+            pixels[y*size + x] = (Color){ 255, 255, 255, (unsigned char)(coverage*255.0f) };
+        }
+    }
+
+    Image image = { 0 };
+    image.data = pixels;
+    image.width = size;
+    image.height = size;
+    image.mipmaps = 1;
+    image.format = PIXELFORMAT_UNCOMPRESSED_R8G8B8A8;
+
+    circleSprite = LoadTextureFromImage(image);
+    SetTextureFilter(circleSprite, TEXTURE_FILTER_BILINEAR);
+    UnloadImage(image);
+}
+
+void UnloadCircleBatch(void)
+{
+    UnloadTexture(circleSprite);
+}
+
+static void PushCircle(float x, float y, float radius, Color color)
+{
+    rlCheckRenderBatchLimit(4);
+
+    rlColor4ub(color.r, color.g, color.b, color.a);
+    rlTexCoord2f(0.0f, 0.0f);
+    rlVertex2f(x - radius, y - radius);
+    rlTexCoord2f(0.0f, 1.0f);
+    rlVertex2f(x - radius, y + radius);
+    rlTexCoord2f(1.0f, 1.0f);
+    rlVertex2f(x + radius, y + radius);
+    rlTexCoord2f(1.0f, 0.0f);
+    rlVertex2f(x + radius, y - radius);
+}
+
+void DrawProjectileBatch(const ProjectilePool &pool, ProjectileStyle style, float alpha)
+{
+    int n = pool.size();
+    if (n == 0) return;
+
+    rlSetTexture(circleSprite.id);
+    rlBegin(RL_QUADS);
+        rlNormal3f(0.0f, 0.0f, 1.0f);
+
+        // Outline then fill per projectile, same order the DrawCircleV calls used
+        for (int i = 0; i < n; i++) {
+            float x = pool.lerpX(i, alpha);
+            float y = pool.lerpY(i, alpha);
+            if (pool.active(i)) {
+                if (style.outlineWidth > 0.0f) PushCircle(x, y, pool.r[i] + style.outlineWidth, style.outlineColor);
+                PushCircle(x, y, pool.r[i], pool.color[i]);
+            }
+            else {
+                Color faded = style.grayWhenInactive? Fade(LIGHTGRAY, 0.3f) : Fade(pool.color[i], 0.3f);
+                PushCircle(x, y, pool.r[i], faded);
+            }
+        }
+    rlEnd();
+    rlSetTexture(0);
+}
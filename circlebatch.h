@@ -0,0 +1,31 @@
+/*******************************************************************************************
+*
+*   circlebatch - batched drawing of meteors and bullets
+*
+*   Every projectile is a textured quad cut from one pre-baked, anti-aliased disc sprite
+*   and tinted per instance through the vertex color, so a whole ProjectilePool goes out
+*   in a single rlgl batch (split only when the batch buffer fills) with one texture
+*   bind, instead of one DrawCircleV submission per circle. Plain GL quads, so it runs
+*   on software GL (llvmpipe) as well.
+*
+********************************************************************************************/
+
+#ifndef CIRCLEBATCH_H
+#define CIRCLEBATCH_H
+
+#include "raylib.h"
+#include "projectile.h"
+
+#define CIRCLE_SPRITE_SIZE  64      // disc sprite edge in pixels
+
+typedef struct ProjectileStyle {
+    float outlineWidth;     // ring drawn under every active projectile, 0 for none
+    Color outlineColor;
+    bool grayWhenInactive;  // inactive ones drawn as faded LIGHTGRAY instead of their faded tint
+} ProjectileStyle;
+
+void InitCircleBatch(void);     // Bake the disc sprite (needs the GL context)
+void UnloadCircleBatch(void);
+void DrawProjectileBatch(const ProjectilePool &pool, ProjectileStyle style, float alpha);  // alpha: interpolation between last two ticks
+
+#endif // CIRCLEBATCH_H
@@ -0,0 +1,243 @@
+/*******************************************************************************************
+*
+*   controls - keyboard and gamepad bindings of the players, loaded from a text file
+*
+********************************************************************************************/
+
+#include "controls.h"
+#include <stdarg.h>
+#include <stdio.h>
+#include <string.h>
+
+//----------------------------------------------------------------------------------
+// Types and Structures Definition
+//----------------------------------------------------------------------------------
+typedef struct NamedCode {
+    const char *name;
+    int code;
+} NamedCode;
+
+//------------------------------------------------------------------------------------
+// Global Variables Declaration
+//------------------------------------------------------------------------------------
+// Letters and digits are their own names, these are the other keys
+static const NamedCode keyNames[] = {
+    { "UP", KEY_UP }, { "LEFT", KEY_LEFT }, { "DOWN", KEY_DOWN }, { "RIGHT", KEY_RIGHT },
+    { "SPACE", KEY_SPACE }, { "ENTER", KEY_ENTER }, { "TAB", KEY_TAB }, { "BACKSPACE", KEY_BACKSPACE },
+    { "COMMA", KEY_COMMA }, { "PERIOD", KEY_PERIOD }, { "SLASH", KEY_SLASH }, { "SEMICOLON", KEY_SEMICOLON },
+    { "LEFT_SHIFT", KEY_LEFT_SHIFT }, { "LEFT_CONTROL", KEY_LEFT_CONTROL }, { "LEFT_ALT", KEY_LEFT_ALT },
+    { "RIGHT_SHIFT", KEY_RIGHT_SHIFT }, { "RIGHT_CONTROL", KEY_RIGHT_CONTROL }, { "RIGHT_ALT", KEY_RIGHT_ALT },
+    { "KP_0", KEY_KP_0 }, { "KP_1", KEY_KP_0 + 1 }, { "KP_2", KEY_KP_0 + 2 }, { "KP_3", KEY_KP_0 + 3 },
+    { "KP_4", KEY_KP_0 + 4 }, { "KP_5", KEY_KP_0 + 5 }, { "KP_6", KEY_KP_0 + 6 }, { "KP_7", KEY_KP_0 + 7 },
+    { "KP_8", KEY_KP_0 + 8 }, { "KP_9", KEY_KP_0 + 9 }, { "KP_ENTER", KEY_KP_ENTER },
+};
+static const int keyNameCount = sizeof(keyNames)/sizeof(keyNames[0]);
+
+// Xbox layout names
+static const NamedCode buttonNames[] = {
+    { "A", GAMEPAD_BUTTON_RIGHT_FACE_DOWN }, { "B", GAMEPAD_BUTTON_RIGHT_FACE_RIGHT },
+    { "X", GAMEPAD_BUTTON_RIGHT_FACE_LEFT }, { "Y", GAMEPAD_BUTTON_RIGHT_FACE_UP },
+    { "LB", GAMEPAD_BUTTON_LEFT_TRIGGER_1 }, { "RB", GAMEPAD_BUTTON_RIGHT_TRIGGER_1 },
+};
+static const int buttonNameCount = sizeof(buttonNames)/sizeof(buttonNames[0]);
+
+// D-pad button of each DIR_*
+static const int dpadButtons[4] = { GAMEPAD_BUTTON_LEFT_FACE_UP, GAMEPAD_BUTTON_LEFT_FACE_LEFT,
+                                    GAMEPAD_BUTTON_LEFT_FACE_DOWN, GAMEPAD_BUTTON_LEFT_FACE_RIGHT };
+
+//----------------------------------------------------------------------------------
+// Module Functions Definitions (local)
+//----------------------------------------------------------------------------------
+static int FindCode(const NamedCode *table, int count, const char *name)
+{
+    for (int i = 0; i < count; i++) {
+        if (strcmp(name, table[i].name) == 0) return table[i].code;
+    }
+    return -1;
+}
+
+static const char *FindName(const NamedCode *table, int count, int code)
+{
+    for (int i = 0; i < count; i++) {
+        if (table[i].code == code) return table[i].name;
+    }
+    return "?";
+}
+
+static int ParseKey(const char *name)
+{
+    if (name[0] != '\0' && name[1] == '\0') {
+        if (name[0] >= 'A' && name[0] <= 'Z') return name[0];
+        if (name[0] >= 'a' && name[0] <= 'z') return name[0] - 'a' + 'A';
+        if (name[0] >= '0' && name[0] <= '9') return name[0];
+    }
+    return FindCode(keyNames, keyNameCount, name);
+}
+
+static void AddKeys(ControlMap *controls, int player, int up, int left, int down, int right, int fire)
+{
+    Binding &binding = controls->bindings[controls->count++];
+    binding.player = player;
+    binding.device = BIND_KEYS;
+    binding.keys[DIR_UP] = up;
+    binding.keys[DIR_LEFT] = left;
+    binding.keys[DIR_DOWN] = down;
+    binding.keys[DIR_RIGHT] = right;
+    binding.keys[4] = fire;
+    binding.gamepad = 0;
+    binding.fireButton = 0;
+    if (player + 1 > controls->players) controls->players = player + 1;
+}
+
+static bool ParseBinding(const char *line, ControlMap *controls)
+{
+    int player = 0;
+    char device[16] = { 0 };
+    char names[5][32] = { { 0 } };
+    int fields = sscanf(line, "%*s %d %15s %31s %31s %31s %31s %31s", &player, device, names[0], names[1], names[2], names[3], names[4]);
+    if (fields < 3 || player < 1 || player > MAX_PLAYERS || controls->count >= CONTROLS_MAX_BINDINGS) return false;
+
+    if (strcmp(device, "keys") == 0) {
+        if (fields != 7) return false;
+        int codes[5];
+        for (int k = 0; k < 5; k++) {
+            codes[k] = ParseKey(names[k]);
+            if (codes[k] < 0) return false;
+        }
+        AddKeys(controls, player - 1, codes[0], codes[1], codes[2], codes[3], codes[4]);
+        return true;
+    }
+
+    if (strcmp(device, "gamepad") == 0) {
+        int gamepad = 0;
+        if (fields > 4 || sscanf(names[0], "%d", &gamepad) != 1 || gamepad < 0) return false;
+        int fireButton = (fields == 4)? FindCode(buttonNames, buttonNameCount, names[1]) : GAMEPAD_BUTTON_RIGHT_FACE_DOWN;
+        if (fireButton < 0) return false;
+
+        Binding &binding = controls->bindings[controls->count++];
+        memset(&binding, 0, sizeof(binding));
+        binding.player = player - 1;
+        binding.device = BIND_GAMEPAD;
+        binding.gamepad = gamepad;
+        binding.fireButton = fireButton;
+        if (player > controls->players) controls->players = player;
+        return true;
+    }
+
+    return false;
+}
+
+// printf at the end of text, cut to size
+static void Append(char *text, int size, int *used, const char *format, ...)
+{
+    if (*used >= size - 1) return;
+
+    va_list args;
+    va_start(args, format);
+    int written = vsnprintf(text + *used, size - *used, format, args);
+    va_end(args);
+    if (written > 0) *used = (*used + written < size)? *used + written : size - 1;
+}
+
+static void KeyName(int key, char *text, int size)
+{
+    if ((key >= 'A' && key <= 'Z') || (key >= '0' && key <= '9')) snprintf(text, size, "%c", key);
+    else snprintf(text, size, "%s", FindName(keyNames, keyNameCount, key));
+}
+
+//----------------------------------------------------------------------------------
+// Module Functions Definitions
+//----------------------------------------------------------------------------------
+void DefaultControls(ControlMap *controls)
+{
+    controls->count = 0;
+    controls->players = 0;
+    AddKeys(controls, 0, KEY_UP, KEY_LEFT, KEY_DOWN, KEY_RIGHT, KEY_ENTER);
+    AddKeys(controls, 1, KEY_W, KEY_A, KEY_S, KEY_D, KEY_SPACE);
+}
+
+bool LoadControls(const char *fileName, ControlMap *controls)
+{
+    controls->count = 0;
+    controls->players = 0;
+
+    FILE *file = fopen(fileName, "r");
+    if (file != NULL) {
+        char line[CONTROLS_LINE_LENGTH];
+        int lineNumber = 0;
+        while (fgets(line, sizeof(line), file) != NULL) {
+            lineNumber++;
+            char keyword[16] = { 0 };
+            if (sscanf(line, "%15s", keyword) != 1 || keyword[0] == '#') continue;
+
+            if (strcmp(keyword, "player") != 0 || !ParseBinding(line, controls)) {
+                printf("controls: %s:%d: bad binding\n", fileName, lineNumber);
+            }
+        }
+        fclose(file);
+    }
+
+    if (controls->count > 0) return true;
+
+    DefaultControls(controls);
+    return false;
+}
+
+void PollControls(const ControlMap &controls, InputFrame *input)
+{
+    for (int b = 0; b < controls.count; b++) {
+        const Binding &binding = controls.bindings[b];
+        unsigned char &buttons = input->player[binding.player];
+
+        if (binding.device == BIND_KEYS) {
+            for (int dir = 0; dir < 4; dir++) {
+                if (IsKeyDown(binding.keys[dir])) buttons |= (1 << dir);
+            }
+            if (IsKeyPressed(binding.keys[4])) buttons |= INPUT_FIRE;
+        }
+        else if (IsGamepadAvailable(binding.gamepad)) {
+            for (int dir = 0; dir < 4; dir++) {
+                if (IsGamepadButtonDown(binding.gamepad, dpadButtons[dir])) buttons |= (1 << dir);
+            }
+            float x = GetGamepadAxisMovement(binding.gamepad, GAMEPAD_AXIS_LEFT_X);
+            float y = GetGamepadAxisMovement(binding.gamepad, GAMEPAD_AXIS_LEFT_Y);
+            if (x < -CONTROLS_STICK_DEADZONE) buttons |= INPUT_LEFT;
+            if (x > CONTROLS_STICK_DEADZONE) buttons |= INPUT_RIGHT;
+            if (y < -CONTROLS_STICK_DEADZONE) buttons |= INPUT_UP;
+            if (y > CONTROLS_STICK_DEADZONE) buttons |= INPUT_DOWN;
+            if (IsGamepadButtonPressed(binding.gamepad, binding.fireButton)) buttons |= INPUT_FIRE;
+        }
+    }
+}
+
+void DescribeControls(const ControlMap &controls, int player, char *text, int size)
+{
+    int used = 0;
+    text[0] = '\0';
+    for (int b = 0; b < controls.count; b++) {
+        const Binding &binding = controls.bindings[b];
+        if (binding.player != player) continue;
+
+        const char *separator = (used > 0)? " OR " : "";
+        if (binding.device == BIND_GAMEPAD) {
+            Append(text, size, &used, "%sGAMEPAD %d + %s", separator, binding.gamepad + 1,
+                   FindName(buttonNames, buttonNameCount, binding.fireButton));
+            continue;
+        }
+
+        char fire[16];
+        KeyName(binding.keys[4], fire, sizeof(fire));
+        if (binding.keys[DIR_UP] == KEY_UP && binding.keys[DIR_LEFT] == KEY_LEFT &&
+            binding.keys[DIR_DOWN] == KEY_DOWN && binding.keys[DIR_RIGHT] == KEY_RIGHT) {
+            Append(text, size, &used, "%sARROW KEYS + %s", separator, fire);
+            continue;
+        }
+
+        // Up, left, down, right like the file, which reads WASD for the usual layout
+        char names[4][16];
+        for (int dir = 0; dir < 4; dir++) KeyName(binding.keys[dir], names[dir], sizeof(names[dir]));
+        bool letters = strlen(names[0]) == 1 && strlen(names[1]) == 1 && strlen(names[2]) == 1 && strlen(names[3]) == 1;
+        Append(text, size, &used, letters? "%s%s%s%s%s + %s" : "%s%s/%s/%s/%s + %s", separator,
+               names[DIR_UP], names[DIR_LEFT], names[DIR_DOWN], names[DIR_RIGHT], fire);
+    }
+}
@@ -0,0 +1,53 @@
+/*******************************************************************************************
+*
+*   controls - keyboard and gamepad bindings of the players, loaded from a text file
+*
+*   Every line of the file binds one device to one player; a player may have several (keys
+*   and a gamepad, say) and the game has as many players as the highest one bound:
+*
+*       player <n> keys <up> <left> <down> <right> <fire>
+*       player <n> gamepad <index> [fire button: A B X Y LB RB, A by default]
+*
+*   Keys are letters, digits or names like UP, ENTER, SPACE, LEFT_SHIFT, KP_0 (see
+*   keyNames in controls.cpp). A gamepad steers with the d-pad or the left stick. Lines
+*   that do not parse are reported and skipped; with no valid line at all (or no file)
+*   the two default players are bound: arrows + ENTER and WASD + SPACE.
+*
+********************************************************************************************/
+
+#ifndef CONTROLS_H
+#define CONTROLS_H
+
+#include "raylib.h"
+#include "world.h"
+
+#define CONTROLS_PATH           "controls.txt"
+#define CONTROLS_MAX_BINDINGS   (2*MAX_PLAYERS)
+#define CONTROLS_LINE_LENGTH    256
+#define CONTROLS_STICK_DEADZONE 0.5f
+
+enum BindingDevice {
+    BIND_KEYS = 0,
+    BIND_GAMEPAD
+};
+
+typedef struct Binding {
+    int player;             // 0 based
+    int device;             // BindingDevice
+    int keys[5];            // BIND_KEYS: KEY_* of DIR_UP, DIR_LEFT, DIR_DOWN, DIR_RIGHT, then fire
+    int gamepad;            // BIND_GAMEPAD: raylib gamepad index
+    int fireButton;         // BIND_GAMEPAD: GAMEPAD_BUTTON_*
+} Binding;
+
+typedef struct ControlMap {
+    Binding bindings[CONTROLS_MAX_BINDINGS];
+    int count;
+    int players;            // highest player bound, the SimConfig playerCount of the game
+} ControlMap;
+
+void DefaultControls(ControlMap *controls);                         // Arrows + ENTER, WASD + SPACE
+bool LoadControls(const char *fileName, ControlMap *controls);      // false (and the defaults) when nothing was bound
+void PollControls(const ControlMap &controls, InputFrame *input);   // OR held directions and fire presses into input
+void DescribeControls(const ControlMap &controls, int player, char *text, int size);   // "ARROW KEYS + ENTER", for the help line
+
+#endif // CONTROLS_H
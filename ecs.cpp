@@ -0,0 +1,244 @@
+/*******************************************************************************************
+*
+*   ecs - archetype storage and the shared systems of the actors (players and bosses)
+*
+********************************************************************************************/
+
+#include "ecs.h"
+#include "trig.h"
+#include <math.h>
+
+// Stable in-place removal of the rows at ascending ids from one column
+template <class T>
+static void compactColumn(vector<T> &column, const vector<int> &ids)
+{
+    if (column.empty() || ids.empty()) return;
+
+    size_t next = 0;
+    int write = ids[0];
+    for (int read = ids[0]; read < (int)column.size(); read++) {
+        if (next < ids.size() && ids[next] == read) {
+            while (next < ids.size() && ids[next] == read) next++;
+            continue;
+        }
+        column[write++] = column[read];
+    }
+    column.resize(write);
+}
+
+//------------------------------------------------------------------------------------
+// Archetype
+//------------------------------------------------------------------------------------
+Archetype::Archetype(const ArchetypeDesc &archetypeDesc, int capacity)
+{
+    desc = archetypeDesc;
+    count = 0;
+    maxCount = capacity;
+
+    // Only the columns of the components in the mask are ever filled
+    if (has(COMP_TRANSFORM)) {
+        position.reserve(capacity);
+        prevPosition.reserve(capacity);
+    }
+    if (has(COMP_MOTION)) {
+        speed.reserve(capacity);
+        acceleration.reserve(capacity);
+        rotation.reserve(capacity);
+        heading.reserve(capacity);
+        headingRotation.reserve(capacity);
+    }
+    if (has(COMP_COLLIDER)) collider.reserve(capacity);
+    if (has(COMP_HEALTH)) {
+        hp.reserve(capacity);
+        dead.reserve(capacity);
+    }
+    if (has(COMP_SPRITE)) {
+        color.reserve(capacity);
+        facing.reserve(capacity);
+        frameRow.reserve(capacity);
+    }
+    if (has(COMP_PILOT)) direction.reserve(capacity);
+}
+
+void Archetype::clear()
+{
+    count = 0;
+    position.clear();
+    prevPosition.clear();
+    speed.clear();
+    acceleration.clear();
+    rotation.clear();
+    heading.clear();
+    headingRotation.clear();
+    collider.clear();
+    hp.clear();
+    color.clear();
+    facing.clear();
+    frameRow.clear();
+    direction.clear();
+}
+
+int Archetype::spawn(Vector2 pos, float rot, float accel, float health, Color tint)
+{
+    if (count >= maxCount) return -1;
+
+    if (has(COMP_TRANSFORM)) {
+        position.push_back(pos);
+        prevPosition.push_back(pos);
+    }
+    if (has(COMP_MOTION)) {
+        speed.push_back((Vector2){ 0, 0 });
+        acceleration.push_back(accel);
+        rotation.push_back(rot);
+        heading.push_back((Vector2){ 0, 0 });
+        headingRotation.push_back(NAN);
+    }
+    if (has(COMP_COLLIDER)) {
+        collider.push_back((Rectangle){ pos.x + desc.colliderOffset.x, pos.y + desc.colliderOffset.y,
+                                        desc.colliderSize.x, desc.colliderSize.y });
+    }
+    if (has(COMP_HEALTH)) hp.push_back(health);
+    if (has(COMP_SPRITE)) {
+        color.push_back(tint);
+        facing.push_back(-1);
+        frameRow.push_back(0);
+    }
+    if (has(COMP_PILOT)) direction.push_back(0);
+
+    return count++;
+}
+
+void Archetype::removeSorted(const vector<int> &ids)
+{
+    if (ids.empty()) return;
+
+    compactColumn(position, ids);
+    compactColumn(prevPosition, ids);
+    compactColumn(speed, ids);
+    compactColumn(acceleration, ids);
+    compactColumn(rotation, ids);
+    compactColumn(heading, ids);
+    compactColumn(headingRotation, ids);
+    compactColumn(collider, ids);
+    compactColumn(hp, ids);
+    compactColumn(color, ids);
+    compactColumn(facing, ids);
+    compactColumn(frameRow, ids);
+    compactColumn(direction, ids);
+
+    int removed = 0;
+    for (int k = 0; k < (int)ids.size(); k++) {
+        if (k == 0 || ids[k] != ids[k - 1]) removed++;
+    }
+    count -= removed;
+}
+
+bool Archetype::resize(int rows)
+{
+    if (rows < 0 || rows > maxCount) return false;
+
+    count = rows;
+    if (has(COMP_TRANSFORM)) {
+        position.resize(rows);
+        prevPosition.resize(rows);
+    }
+    if (has(COMP_MOTION)) {
+        speed.resize(rows);
+        acceleration.resize(rows);
+        rotation.resize(rows);
+        heading.resize(rows);
+        headingRotation.assign(rows, NAN);     // loaded rotations, headings to be redone
+    }
+    if (has(COMP_COLLIDER)) collider.resize(rows);
+    if (has(COMP_HEALTH)) hp.resize(rows);
+    if (has(COMP_SPRITE)) {
+        color.resize(rows);
+        facing.resize(rows);
+        frameRow.resize(rows);
+    }
+    if (has(COMP_PILOT)) direction.resize(rows);
+    return true;
+}
+
+//------------------------------------------------------------------------------------
+// Systems
+//------------------------------------------------------------------------------------
+void savePositionSystem(Archetype &a)
+{
+    if (!a.has(COMP_TRANSFORM)) return;
+
+    for (int i = 0; i < a.size(); i++) a.prevPosition[i] = a.position[i];
+}
+
+// Speed follows the rotation (0 is up, clockwise), scaled by the acceleration. Rotations
+// change seldom (bosses turn once per attack cycle), so the heading is only redone then
+void movementSystem(Archetype &a, JobSystem *jobs)
+{
+    if (!a.has(COMP_TRANSFORM | COMP_MOTION)) return;
+
+    ParallelFor(jobs, a.size(), ARCHETYPE_GRAIN, [&a](int begin, int end, int worker) {
+        float moveSpeed = a.desc.moveSpeed;
+        for (int i = begin; i < end; i++) {
+            if (a.rotation[i] != a.headingRotation[i]) {
+                a.heading[i].x = angleSin(a.rotation[i]);
+                a.heading[i].y = angleCos(a.rotation[i]);
+                a.headingRotation[i] = a.rotation[i];
+            }
+            a.speed[i].x = a.heading[i].x * moveSpeed;
+            a.speed[i].y = a.heading[i].y * moveSpeed;
+            a.position[i].x += a.speed[i].x * a.acceleration[i];
+            a.position[i].y -= a.speed[i].y * a.acceleration[i];
+        }
+    });
+}
+
+void wallClampSystem(Archetype &a, float w, float h, JobSystem *jobs)
+{
+    if (!a.has(COMP_TRANSFORM)) return;
+
+    ParallelFor(jobs, a.size(), ARCHETYPE_GRAIN, [&a, w, h](int begin, int end, int worker) {
+        float slack = a.desc.wallSlack;
+        for (int i = begin; i < end; i++) {
+            Vector2 &p = a.position[i];
+            if (p.x > w) p.x = w;
+            else if (p.x < -slack) p.x = 0;
+            if (p.y > h) p.y = h;
+            else if (p.y < -slack) p.y = 0;
+        }
+    });
+}
+
+void colliderSyncSystem(Archetype &a)
+{
+    if (!a.has(COMP_TRANSFORM | COMP_COLLIDER)) return;
+
+    for (int i = 0; i < a.size(); i++) {
+        a.collider[i].x = a.position[i].x + a.desc.colliderOffset.x;
+        a.collider[i].y = a.position[i].y + a.desc.colliderOffset.y;
+    }
+}
+
+// Damage itself is subtracted where the hit is found, so later hits of the same tick see
+// it; this settles the deaths afterwards
+int damageSystem(Archetype &a)
+{
+    if (!a.has(COMP_HEALTH)) return a.size();
+
+    a.dead.clear();
+    for (int i = 0; i < a.size(); i++) {
+        if (a.hp[i] <= 0) a.dead.push_back(i);
+    }
+    int living = a.size() - (int)a.dead.size();
+    if (a.desc.despawnOnDeath) a.removeSorted(a.dead);
+
+    return living;
+}
+
+void animationSystem(Archetype &a)
+{
+    if (!a.has(COMP_SPRITE)) return;
+
+    for (int i = 0; i < a.size(); i++) {
+        if (a.facing[i] >= 0) a.frameRow[i] = a.desc.spriteRows[a.facing[i]];
+    }
+}
@@ -0,0 +1,98 @@
+/*******************************************************************************************
+*
+*   ecs - archetype storage and the shared systems of the actors (players and bosses)
+*
+*   An Archetype is one kind of actor: a component mask, the tuning every entity of that
+*   kind shares (ArchetypeDesc) and one contiguous column per component field, the same
+*   layout ProjectilePool uses for meteors and bullets. An entity is a row; removal is a
+*   stable compaction so rows keep their spawn order. Capacity is fixed at construction.
+*
+*   Systems take an archetype and do nothing unless it has every component they read, so
+*   the world can run them on any set of archetypes and a new kind of actor only needs a
+*   descriptor. What only one kind does (input, chasing) stays in the world's phases.
+*
+********************************************************************************************/
+
+#ifndef ECS_H
+#define ECS_H
+
+#include "simtypes.h"
+#include "jobs.h"
+#include <vector>
+using namespace std;
+
+// Components, an archetype stores the columns of the ones in its mask
+enum Component {
+    COMP_TRANSFORM  = 1 << 0,   // position, prevPosition
+    COMP_MOTION     = 1 << 1,   // speed, acceleration, rotation, heading
+    COMP_COLLIDER   = 1 << 2,   // collider
+    COMP_HEALTH     = 1 << 3,   // hp
+    COMP_SPRITE     = 1 << 4,   // color, facing, frameRow
+    COMP_PILOT      = 1 << 5    // direction (steered by input)
+};
+
+// Per entity systems split across workers in chunks of at least this many rows
+#define ARCHETYPE_GRAIN     16
+
+// What every entity of an archetype shares
+struct ArchetypeDesc {
+    unsigned components;
+    float moveSpeed;            // speed along rotation at full acceleration
+    Vector2 colliderOffset;     // collider corner relative to the position
+    Vector2 colliderSize;
+    float wallSlack;            // how far past the left and top walls before being put back
+    bool despawnOnDeath;        // dead rows are removed, otherwise they stay with hp <= 0
+    int spriteRows[4];          // sprite sheet row of each DIR_* facing
+};
+
+class Archetype {
+public:
+    ArchetypeDesc desc;
+
+    vector<Vector2> position;
+    vector<Vector2> prevPosition;   // position at the start of the last tick, for render interpolation
+    vector<Vector2> speed;
+    vector<float> acceleration;
+    vector<float> rotation;
+    vector<Vector2> heading;        // sin and cos of the rotation, redone when the rotation changes
+    vector<float> headingRotation;  // rotation heading was worked out for, NaN: not yet
+    vector<Rectangle> collider;
+    vector<float> hp;
+    vector<Color> color;
+    vector<int> facing;             // DIR_* to show, -1 until the entity first turns
+    vector<int> frameRow;           // sprite sheet row of the current facing
+    vector<int> direction;          // DIR_* last steered to
+
+    Archetype(const ArchetypeDesc &desc, int capacity);
+
+    int size() const { return count; }
+    int capacity() const { return maxCount; }
+    bool has(unsigned components) const { return (desc.components & components) == components; }
+
+    void clear();
+    // Row of the new entity, -1 once the archetype is full
+    int spawn(Vector2 pos, float rot, float accel, float health, Color tint);
+    // Remove the rows at the given ascending indices in one stable pass
+    void removeSorted(const vector<int> &ids);
+    // Set the row count, new rows are zero; for restoring a snapshot, false above capacity
+    bool resize(int rows);
+
+private:
+    int count;
+    int maxCount;
+    vector<int> dead;               // scratch of damageSystem
+
+    friend int damageSystem(Archetype &archetype);
+};
+
+//----------------------------------------------------------------------------------
+// Systems
+//----------------------------------------------------------------------------------
+void savePositionSystem(Archetype &archetype);                          // TRANSFORM
+void movementSystem(Archetype &archetype, JobSystem *jobs);             // TRANSFORM | MOTION
+void wallClampSystem(Archetype &archetype, float w, float h, JobSystem *jobs);  // TRANSFORM
+void colliderSyncSystem(Archetype &archetype);                          // TRANSFORM | COLLIDER
+int damageSystem(Archetype &archetype);                                 // HEALTH, returns the living
+void animationSystem(Archetype &archetype);                             // SPRITE
+
+#endif // ECS_H
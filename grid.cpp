@@ -0,0 +1,78 @@
+/*******************************************************************************************
+*
+*   grid - uniform grid broadphase
+*
+********************************************************************************************/
+
+#include "grid.h"
+#include <algorithm>
+#include <math.h>
+
+UniformGrid::UniformGrid(float width, float height, float cellSize, int capacity)
+{
+    this->cellSize = cellSize;
+    invCellSize = 1.0f/cellSize;
+    cols = (int)ceilf(width/cellSize);
+    rows = (int)ceilf(height/cellSize);
+    cellStart.assign(cols*rows + 1, 0);
+    cellOf.reserve(capacity);
+    items.reserve(capacity);
+}
+
+int UniformGrid::cellX(float x) const
+{
+    int cx = (int)floorf(x*invCellSize);
+    if (cx < 0) return 0;
+    if (cx >= cols) return cols - 1;
+    return cx;
+}
+
+int UniformGrid::cellY(float y) const
+{
+    int cy = (int)floorf(y*invCellSize);
+    if (cy < 0) return 0;
+    if (cy >= rows) return rows - 1;
+    return cy;
+}
+
+void UniformGrid::reset(int count)
+{
+    cellOf.resize(count);
+    items.resize(count);
+    fill(cellStart.begin(), cellStart.end(), 0);
+}
+
+void UniformGrid::insert(int id, Vector2 position)
+{
+    int cell = cellY(position.y)*cols + cellX(position.x);
+    cellOf[id] = cell;
+    cellStart[cell + 1]++;
+}
+
+void UniformGrid::finalize()
+{
+    int cellNum = cols*rows;
+    for (int c = 0; c < cellNum; c++) cellStart[c + 1] += cellStart[c];
+
+    // cellStart[c] is used as the write cursor of cell c, then shifted back
+    for (int id = 0; id < (int)cellOf.size(); id++) {
+        items[cellStart[cellOf[id]]++] = id;
+    }
+    for (int c = cellNum; c > 0; c--) cellStart[c] = cellStart[c - 1];
+    cellStart[0] = 0;
+}
+
+void UniformGrid::query(Vector2 position, float reach, vector<int> &out) const
+{
+    int x0 = cellX(position.x - reach);
+    int x1 = cellX(position.x + reach);
+    int y0 = cellY(position.y - reach);
+    int y1 = cellY(position.y + reach);
+
+    for (int cy = y0; cy <= y1; cy++) {
+        for (int cx = x0; cx <= x1; cx++) {
+            int cell = cy*cols + cx;
+            for (int k = cellStart[cell]; k < cellStart[cell + 1]; k++) out.push_back(items[k]);
+        }
+    }
+}
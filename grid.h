@@ -0,0 +1,53 @@
+/*******************************************************************************************
+*
+*   grid - uniform grid broadphase
+*
+*   Points are bucketed into fixed size cells with a counting sort, so every cell holds a
+*   contiguous, ascending run of ids. Positions outside the arena are clamped into the
+*   border cells. All storage is kept between builds; a steady frame does not allocate.
+*
+********************************************************************************************/
+
+#ifndef GRID_H
+#define GRID_H
+
+#include "simtypes.h"
+#include <vector>
+using namespace std;
+
+// Cell edge: METEOR_MAX_RADIUS (20) plus the bullet radius (5), rounded up so that any
+// overlap between a bullet and a meteor is found in the 3x3 cells around the bullet
+#define GRID_CELL_SIZE      40.0f
+
+// Below this many bullet x meteor pairs the plain nested loop is cheaper than a rebuild
+#define GRID_MIN_PAIRS      256
+
+// Queries per build below which a linear scan per query is cheaper anyway
+#define GRID_MIN_QUERIES    8
+
+class UniformGrid {
+public:
+    UniformGrid(float width, float height, float cellSize, int capacity);
+
+    void reset(int count);                  // Start a build for ids [0, count)
+    void insert(int id, Vector2 position);  // Record the cell of one id
+    void finalize();                        // Sort recorded ids into cell runs
+
+    // Ids of the cells overlapping [position - reach, position + reach], cell by cell
+    void query(Vector2 position, float reach, vector<int> &out) const;
+
+    int cols;
+    int rows;
+
+private:
+    float cellSize;
+    float invCellSize;
+    vector<int> cellOf;     // cell of each inserted id
+    vector<int> cellStart;  // cols*rows + 1 prefix sums into items
+    vector<int> items;      // ids ordered by cell, ascending within a cell
+
+    int cellX(float x) const;
+    int cellY(float y) const;
+};
+
+#endif // GRID_H
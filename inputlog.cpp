@@ -0,0 +1,172 @@
+/*******************************************************************************************
+*
+*   inputlog - compact binary recording of the per tick input of a match
+*
+********************************************************************************************/
+
+#include "inputlog.h"
+#include <stdio.h>
+#include <string.h>
+#include <algorithm>
+
+static const unsigned char logMagic[4] = { 'B', 'T', 'B', 'R' };
+
+static void putU32(unsigned char *out, uint32_t value)
+{
+    for (int i = 0; i < 4; i++) out[i] = (unsigned char)(value >> (8*i));
+}
+
+static uint32_t getU32(const unsigned char *in)
+{
+    uint32_t value = 0;
+    for (int i = 0; i < 4; i++) value |= (uint32_t)in[i] << (8*i);
+    return value;
+}
+
+static bool sameFrame(const InputFrame &a, const InputFrame &b)
+{
+    return memcmp(a.player, b.player, MAX_PLAYERS) == 0 && a.system == b.system;
+}
+
+// What a World can be set up with
+static bool validCounts(int players, int bosses)
+{
+    return players >= 1 && players <= MAX_PLAYERS && bosses >= 1 && bosses <= MAX_BOSSES;
+}
+
+InputLog::InputLog()
+{
+    seed = 0;
+    ticks = 0;
+    checksum = 0;
+    players = PLAYER_COUNT;
+    bosses = BOSS_COUNT;
+    runLength = 0;
+    readPos = 0;
+    runLeft = 0;
+    memset(&runFrame, 0, sizeof(runFrame));
+    memset(&readFrame, 0, sizeof(readFrame));
+}
+
+void InputLog::begin(uint32_t matchSeed, const SimConfig &config)
+{
+    // What World::init plays with, not what was asked for: the header stores one byte each
+    seed = matchSeed;
+    players = max(1, min(config.playerCount, MAX_PLAYERS));
+    bosses = max(1, min(config.bossCount, MAX_BOSSES));
+    ticks = 0;
+    checksum = 0;
+    runs.clear();
+    runLength = 0;
+}
+
+void InputLog::record(const InputFrame &frame)
+{
+    if (runLength > 0 && !sameFrame(frame, runFrame)) closeRun();
+
+    runFrame = frame;
+    runLength++;
+    ticks++;
+}
+
+void InputLog::closeRun()
+{
+    if (runLength == 0) return;
+
+    uint32_t length = runLength;
+    do {
+        unsigned char byte = length & 0x7f;
+        length >>= 7;
+        runs.push_back(length? (byte | 0x80) : byte);
+    } while (length);
+
+    runs.insert(runs.end(), runFrame.player, runFrame.player + players);
+    runs.push_back(runFrame.system);
+    runLength = 0;
+}
+
+bool InputLog::save(const char *fileName, uint32_t finalChecksum)
+{
+    closeRun();
+    checksum = finalChecksum;
+
+    unsigned char header[INPUTLOG_HEADER];
+    memcpy(header, logMagic, 4);
+    header[4] = INPUTLOG_VERSION & 0xff;
+    header[5] = INPUTLOG_VERSION >> 8;
+    header[6] = (unsigned char)players;
+    header[7] = (unsigned char)bosses;
+    putU32(header + 8, seed);
+    putU32(header + 12, ticks);
+    putU32(header + 16, checksum);
+
+    FILE *file = fopen(fileName, "wb");
+    if (file == NULL) return false;
+    bool ok = fwrite(header, 1, INPUTLOG_HEADER, file) == INPUTLOG_HEADER;
+    if (!runs.empty()) ok = ok && fwrite(runs.data(), 1, runs.size(), file) == runs.size();
+    fclose(file);
+
+    return ok;
+}
+
+bool InputLog::load(const char *fileName)
+{
+    FILE *file = fopen(fileName, "rb");
+    if (file == NULL) return false;
+
+    unsigned char header[INPUTLOG_HEADER];
+    bool ok = fread(header, 1, INPUTLOG_HEADER, file) == INPUTLOG_HEADER;
+    ok = ok && memcmp(header, logMagic, 4) == 0;
+    ok = ok && (header[4] | (header[5] << 8)) == INPUTLOG_VERSION;
+    ok = ok && validCounts(header[6], header[7]? header[7] : 1);
+    if (!ok) {
+        fclose(file);
+        return false;
+    }
+
+    seed = getU32(header + 8);
+    ticks = getU32(header + 12);
+    checksum = getU32(header + 16);
+    players = header[6];
+    bosses = header[7]? header[7] : 1;
+
+    runs.clear();
+    unsigned char buffer[4096];
+    size_t read;
+    while ((read = fread(buffer, 1, sizeof(buffer), file)) > 0) runs.insert(runs.end(), buffer, buffer + read);
+    fclose(file);
+
+    rewind();
+    return true;
+}
+
+void InputLog::rewind()
+{
+    readPos = 0;
+    runLeft = 0;
+}
+
+bool InputLog::next(InputFrame *frame)
+{
+    if (runLeft == 0) {
+        uint32_t length = 0;
+        int shift = 0;
+        while (readPos < runs.size()) {
+            unsigned char byte = runs[readPos++];
+            length |= (uint32_t)(byte & 0x7f) << shift;
+            shift += 7;
+            if (!(byte & 0x80)) break;
+        }
+        if (length == 0 || readPos + players + 1 > runs.size()) return false;
+
+        memset(readFrame.player, 0, sizeof(readFrame.player));
+        memcpy(readFrame.player, &runs[readPos], players);
+        readFrame.system = runs[readPos + players];
+        readPos += players + 1;
+        runLeft = length;
+    }
+
+    *frame = readFrame;
+    runLeft--;
+    return true;
+}
@@ -0,0 +1,60 @@
+/*******************************************************************************************
+*
+*   inputlog - compact binary recording of the per tick input of a match
+*
+*   A World is fully determined by its seed and the InputFrame of every tick, so this is
+*   all a replay needs. Consecutive identical frames are stored as one run.
+*
+*   File layout (little endian):
+*       header   magic "BTBR", version u16, players u8, bosses u8 (0 in older logs: one),
+*                seed u32, ticks u32, checksum u32 (World::checksum() after the last tick)
+*       runs     run length as LEB128 varint, then one frame: players bytes + system byte,
+*                repeated until the runs cover ticks frames
+*
+********************************************************************************************/
+
+#ifndef INPUTLOG_H
+#define INPUTLOG_H
+
+#include "world.h"
+#include <stdint.h>
+#include <vector>
+using namespace std;
+
+#define INPUTLOG_VERSION    1
+#define INPUTLOG_HEADER     20      // header size in bytes
+
+class InputLog {
+public:
+    uint32_t seed;
+    uint32_t ticks;
+    uint32_t checksum;      // world checksum after the last tick
+    int players;            // SimConfig playerCount and bossCount of the match
+    int bosses;
+
+    InputLog();
+
+    // Recording
+    void begin(uint32_t matchSeed, const SimConfig &config);
+    void record(const InputFrame &frame);
+    bool save(const char *fileName, uint32_t finalChecksum);
+
+    // Playback
+    bool load(const char *fileName);
+    void rewind();
+    bool next(InputFrame *frame);   // false once every recorded tick was returned
+
+private:
+    vector<unsigned char> runs;     // encoded runs, without the open one
+
+    InputFrame runFrame;            // open run while recording
+    uint32_t runLength;
+
+    size_t readPos;                 // playback cursor
+    uint32_t runLeft;
+    InputFrame readFrame;
+
+    void closeRun();
+};
+
+#endif // INPUTLOG_H
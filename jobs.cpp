@@ -0,0 +1,141 @@
+/*******************************************************************************************
+*
+*   jobs - small work-stealing job system for the simulation phases
+*
+********************************************************************************************/
+
+#include "jobs.h"
+
+//----------------------------------------------------------------------------------
+// Types and Structures Definition
+//----------------------------------------------------------------------------------
+struct JobChunk {
+    JobFunc func;
+    void *context;
+    int begin;
+    int end;
+};
+
+// Ring of chunks; the owner pops the newest, thieves take the oldest
+struct JobQueue {
+    mutex lock;
+    JobChunk chunks[JOB_QUEUE_CAPACITY];
+    int head;       // oldest
+    int count;
+
+    void push(const JobChunk &chunk) {
+        lock_guard<mutex> guard(lock);
+        chunks[(head + count) % JOB_QUEUE_CAPACITY] = chunk;
+        count++;
+    }
+
+    bool pop(JobChunk *chunk) {
+        lock_guard<mutex> guard(lock);
+        if (count == 0) return false;
+        count--;
+        *chunk = chunks[(head + count) % JOB_QUEUE_CAPACITY];
+        return true;
+    }
+
+    bool steal(JobChunk *chunk) {
+        lock_guard<mutex> guard(lock);
+        if (count == 0) return false;
+        *chunk = chunks[head];
+        head = (head + 1) % JOB_QUEUE_CAPACITY;
+        count--;
+        return true;
+    }
+};
+
+//------------------------------------------------------------------------------------
+// JobSystem
+//------------------------------------------------------------------------------------
+JobSystem::JobSystem(int threadCount) : pending(0), generation(0), quit(false)
+{
+    if (threadCount <= 0) threadCount = (int)thread::hardware_concurrency();
+    if (threadCount < 1) threadCount = 1;
+    if (threadCount > JOB_MAX_WORKERS) threadCount = JOB_MAX_WORKERS;
+    workers = threadCount;
+
+    queues = new JobQueue[workers];
+    for (int i = 0; i < workers; i++) {
+        queues[i].head = 0;
+        queues[i].count = 0;
+    }
+
+    for (int i = 1; i < workers; i++) threads.push_back(thread(&JobSystem::workerLoop, this, i));
+}
+
+JobSystem::~JobSystem()
+{
+    {
+        lock_guard<mutex> guard(wakeLock);
+        quit = true;
+    }
+    wake.notify_all();
+    for (int i = 0; i < (int)threads.size(); i++) threads[i].join();
+
+    delete[] queues;
+}
+
+void JobSystem::run(int count, int grain, JobFunc func, void *context)
+{
+    if (count <= 0) return;
+    if (grain < 1) grain = 1;
+
+    // Never deal more chunks than the queues hold
+    int slots = workers*JOB_QUEUE_CAPACITY;
+    if ((count + grain - 1)/grain > slots) grain = (count + slots - 1)/slots;
+
+    int chunkCount = (count + grain - 1)/grain;
+    pending.store(chunkCount, memory_order_relaxed);
+
+    for (int c = 0; c < chunkCount; c++) {
+        JobChunk chunk = { func, context, c*grain, (c + 1)*grain < count? (c + 1)*grain : count };
+        queues[c % workers].push(chunk);
+    }
+
+    {
+        lock_guard<mutex> guard(wakeLock);
+        generation++;
+    }
+    wake.notify_all();
+
+    // Help, then wait for the chunks other workers are still running
+    work(0);
+    while (pending.load(memory_order_acquire) > 0) {
+        if (!work(0)) this_thread::yield();
+    }
+}
+
+void JobSystem::workerLoop(int worker)
+{
+    unsigned seen = 0;
+    for (;;) {
+        {
+            unique_lock<mutex> guard(wakeLock);
+            while (!quit && generation == seen) wake.wait(guard);
+            if (quit) return;
+            seen = generation;
+        }
+        work(worker);
+    }
+}
+
+bool JobSystem::work(int worker)
+{
+    bool ran = false;
+    JobChunk chunk;
+
+    for (;;) {
+        bool found = queues[worker].pop(&chunk);
+        for (int k = 1; !found && k < workers; k++) {
+            found = queues[(worker + k) % workers].steal(&chunk);
+        }
+        if (!found) return ran;
+
+        chunk.func(chunk.context, chunk.begin, chunk.end, worker);
+        pending.fetch_sub(1, memory_order_release);
+        ran = true;
+    }
+}
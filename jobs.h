@@ -0,0 +1,74 @@
+/*******************************************************************************************
+*
+*   jobs - small work-stealing job system for the simulation phases
+*
+*   A parallel loop is cut into chunks that are dealt round robin to one queue per worker.
+*   Every worker drains its own queue from the back and, once it is empty, steals from the
+*   front of the others, so uneven chunks still balance out. The calling thread is worker 0
+*   and works too; run() returns when every chunk is done.
+*
+*   Jobs only ever get (begin, end, worker): anything they write must either be disjoint
+*   per index or go to a per worker buffer that the caller merges in a fixed order, so the
+*   result never depends on the worker count or on who stole what.
+*
+********************************************************************************************/
+
+#ifndef JOBS_H
+#define JOBS_H
+
+#include <atomic>
+#include <condition_variable>
+#include <mutex>
+#include <thread>
+#include <vector>
+using namespace std;
+
+#define JOB_MAX_WORKERS     64
+#define JOB_QUEUE_CAPACITY  1024    // chunks per worker queue; the grain grows to fit
+
+typedef void (*JobFunc)(void *context, int begin, int end, int worker);
+
+struct JobQueue;
+
+class JobSystem {
+public:
+    JobSystem(int threadCount);     // 0: one per hardware thread, the caller included
+    ~JobSystem();
+
+    int workerCount() const { return workers; }
+
+    // Call func over [0, count) in chunks of at least grain items and wait for all of them
+    void run(int count, int grain, JobFunc func, void *context);
+
+private:
+    int workers;
+    JobQueue *queues;
+    vector<thread> threads;
+    atomic<int> pending;            // chunks of the current run not finished yet
+
+    mutex wakeLock;
+    condition_variable wake;
+    unsigned generation;            // bumped by every run() to wake the workers
+    bool quit;
+
+    void workerLoop(int worker);
+    bool work(int worker);          // run chunks until none is left to take
+};
+
+template <class F>
+static void JobTrampoline(void *context, int begin, int end, int worker)
+{
+    (*(const F *)context)(begin, end, worker);
+}
+
+// body(begin, end, worker) over [0, count); runs inline when jobs is NULL or the loop is
+// a single chunk, so callers need no serial special case
+template <class F>
+void ParallelFor(JobSystem *jobs, int count, int grain, const F &body)
+{
+    if (count <= 0) return;
+    if (jobs == NULL || jobs->workerCount() == 1 || count <= grain) body(0, count, 0);
+    else jobs->run(count, grain, &JobTrampoline<F>, (void *)&body);
+}
+
+#endif // JOBS_H
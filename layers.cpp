@@ -0,0 +1,59 @@
+/*******************************************************************************************
+*
+*   layers - render texture caches for what does not change from one frame to the next
+*
+********************************************************************************************/
+
+#include "layers.h"
+#include "rlgl.h"
+#include <string.h>
+
+//----------------------------------------------------------------------------------
+// Module Functions Definitions
+//----------------------------------------------------------------------------------
+void LoadCachedLayer(CachedLayer *layer, int width, int height, bool opaque)
+{
+    memset(layer, 0, sizeof(*layer));
+    layer->target = LoadRenderTexture(width, height);
+    layer->opaque = opaque;
+}
+
+void UnloadCachedLayer(CachedLayer *layer)
+{
+    if (layer->target.id != 0) UnloadRenderTexture(layer->target);
+    memset(layer, 0, sizeof(*layer));
+}
+
+bool BeginCachedLayer(CachedLayer *layer, unsigned int key)
+{
+    if (layer->target.id == 0 || (layer->drawn && layer->key == key)) return false;
+
+    layer->key = key;
+    layer->drawn = true;
+    layer->redraws++;
+    BeginTextureMode(layer->target);
+    return true;
+}
+
+void EndCachedLayer(void)
+{
+    EndTextureMode();
+}
+
+// Render textures are upside down in GL, hence the negative source height
+void DrawCachedLayer(const CachedLayer &layer, int x, int y)
+{
+    if (layer.target.id == 0) return;
+
+    Texture2D texture = layer.target.texture;
+    Rectangle source = { 0.0f, 0.0f, (float)texture.width, -(float)texture.height };
+    if (layer.opaque) {
+        rlDrawRenderBatchActive();
+        rlDisableColorBlend();
+    }
+    DrawTextureRec(texture, source, (Vector2){ (float)x, (float)y }, WHITE);
+    if (layer.opaque) {
+        rlDrawRenderBatchActive();
+        rlEnableColorBlend();
+    }
+}
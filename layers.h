@@ -0,0 +1,35 @@
+/*******************************************************************************************
+*
+*   layers - render texture caches for what does not change from one frame to the next
+*
+*   A CachedLayer keeps its content in a render texture along with a key saying what it
+*   was drawn for. Every frame the caller asks BeginCachedLayer() with the key of what the
+*   layer should show now; only when it differs does it get a true back and draw the
+*   content again (into the texture), otherwise the frame just composites the texture
+*   with DrawCachedLayer(). An opaque layer covers its whole area and is copied without
+*   blending, so a full screen one costs one plain fill however much was baked into it.
+*
+*   Redraw layers before BeginDrawing(): switching to a render texture flushes the batch.
+*
+********************************************************************************************/
+
+#ifndef LAYERS_H
+#define LAYERS_H
+
+#include "raylib.h"
+
+typedef struct CachedLayer {
+    RenderTexture2D target;
+    unsigned int key;       // what the content was drawn for
+    bool drawn;             // false until the first redraw, any key differs then
+    bool opaque;            // covers its whole area: composited without blending
+    int redraws;            // since loaded, for the profiler overlay
+} CachedLayer;
+
+void LoadCachedLayer(CachedLayer *layer, int width, int height, bool opaque);   // Needs the GL context
+void UnloadCachedLayer(CachedLayer *layer);
+bool BeginCachedLayer(CachedLayer *layer, unsigned int key);    // true: draw the content now, then EndCachedLayer()
+void EndCachedLayer(void);
+void DrawCachedLayer(const CachedLayer &layer, int x, int y);
+
+#endif // LAYERS_H
@@ -0,0 +1,219 @@
+/*******************************************************************************************
+*
+*   log - leveled logging for "Beat the boss!" that keeps formatting off the game thread
+*
+********************************************************************************************/
+
+#include "log.h"
+#include <string.h>
+#include <atomic>
+#include <chrono>
+#include <thread>
+using namespace std;
+
+#define LOG_DRAIN_SLEEP_US  500     // idle sink thread polls the ring this often
+
+//------------------------------------------------------------------------------------
+// Global Variables Declaration
+//------------------------------------------------------------------------------------
+int logLevel = LOGLEVEL_INFO;
+
+static const char *levelNames[LOGLEVEL_NONE] = { "trace", "debug", "info", "warn", "error" };
+
+static const chrono::steady_clock::time_point logEpoch = chrono::steady_clock::now();
+
+// head is only written by the producer, tail by the sink thread; each on its own line
+static LogRecord ring[LOG_RING_RECORDS];
+alignas(64) static atomic<unsigned> head(0);
+alignas(64) static atomic<unsigned> tail(0);
+alignas(64) static atomic<long> dropped(0);
+
+static FILE *sink = NULL;
+static thread sinkThread;
+static atomic<bool> sinkRunning(false);
+static atomic<bool> sinkQuit(false);
+static LogRecord syncRecord;        // used while no sink thread runs
+
+//------------------------------------------------------------------------------------
+// Module Functions Definitions
+//------------------------------------------------------------------------------------
+static void WriteRecord(FILE *file, const LogRecord &record)
+{
+    char line[LOG_LINE_BYTES];
+    int length = LogFormat(record, line, sizeof(line));
+    fprintf(file, "[%10.6f] %s: ", record.time, LogLevelName(record.level));
+    fwrite(line, 1, length, file);
+}
+
+static void DrainLoop(void)
+{
+    long reported = 0;
+    for (;;) {
+        unsigned last = tail.load(memory_order_relaxed);
+        unsigned first = head.load(memory_order_acquire);
+        if (last == first) {
+            long lost = dropped.load(memory_order_relaxed);
+            if (lost != reported) {
+                fprintf(sink, "log: %ld messages dropped, the ring was full\n", lost - reported);
+                reported = lost;
+            }
+            fflush(sink);
+            if (sinkQuit.load(memory_order_acquire) && head.load(memory_order_acquire) == last) break;
+            this_thread::sleep_for(chrono::microseconds(LOG_DRAIN_SLEEP_US));
+            continue;
+        }
+
+        for (; last != first; last++) WriteRecord(sink, ring[last & (LOG_RING_RECORDS - 1)]);
+        tail.store(last, memory_order_release);
+    }
+}
+
+void LogSetLevel(int level)
+{
+    logLevel = level;
+}
+
+bool LogStart(FILE *file)
+{
+    if (sinkRunning.load()) return false;
+
+    sink = (file != NULL)? file : stdout;
+    sinkQuit.store(false);
+    sinkThread = thread(DrainLoop);
+    sinkRunning.store(true, memory_order_release);
+    return true;
+}
+
+void LogFlush(void)
+{
+    if (!sinkRunning.load(memory_order_acquire)) {
+        fflush((sink != NULL)? sink : stdout);
+        return;
+    }
+
+    unsigned target = head.load(memory_order_relaxed);
+    while ((int)(tail.load(memory_order_acquire) - target) < 0) this_thread::sleep_for(chrono::microseconds(LOG_DRAIN_SLEEP_US));
+}
+
+void LogStop(void)
+{
+    if (!sinkRunning.load()) return;
+
+    sinkQuit.store(true, memory_order_release);
+    sinkThread.join();
+    sinkRunning.store(false, memory_order_release);
+}
+
+long LogDropped(void)
+{
+    return dropped.load(memory_order_relaxed);
+}
+
+const char *LogLevelName(int level)
+{
+    return (level >= 0 && level < LOGLEVEL_NONE)? levelNames[level] : "?";
+}
+
+LogRecord *LogBegin(int level, const char *format)
+{
+    LogRecord *record = &syncRecord;
+    if (sinkRunning.load(memory_order_acquire)) {
+        unsigned next = head.load(memory_order_relaxed);
+        if (next - tail.load(memory_order_acquire) >= LOG_RING_RECORDS) {
+            dropped.fetch_add(1, memory_order_relaxed);
+            return NULL;
+        }
+        record = &ring[next & (LOG_RING_RECORDS - 1)];
+    }
+
+    record->format = format;
+    record->time = chrono::duration<double>(chrono::steady_clock::now() - logEpoch).count();
+    record->level = level;
+    record->argc = 0;
+    record->textUsed = 0;
+    return record;
+}
+
+void LogCommit(LogRecord *record)
+{
+    if (record == &syncRecord) {
+        WriteRecord((sink != NULL)? sink : stdout, *record);
+        return;
+    }
+
+    head.store(head.load(memory_order_relaxed) + 1, memory_order_release);
+}
+
+// Walks the format and hands every conversion its recorded argument, with the length
+// modifier the argument's type needs
+int LogFormat(const LogRecord &record, char *line, int size)
+{
+    int used = 0;
+    int next = 0;
+    const char *f = record.format;
+
+    while (*f != '\0' && used < size - 1) {
+        if (*f != '%') {
+            line[used++] = *f++;
+            continue;
+        }
+        if (f[1] == '%') {
+            line[used++] = '%';
+            f += 2;
+            continue;
+        }
+
+        char spec[32];
+        int n = 0;
+        spec[n++] = *f++;
+        while (*f != '\0' && strchr("-+ #0", *f) != NULL && n < 8) spec[n++] = *f++;
+        while (*f != '\0' && ((*f >= '0' && *f <= '9') || *f == '.') && n < 24) spec[n++] = *f++;
+        while (*f != '\0' && strchr("hlLqjzt", *f) != NULL) f++;
+        char conversion = *f;
+        if (conversion == '\0') break;
+        f++;
+
+        int room = size - used;
+        int written = 0;
+        if (next >= record.argc) written = snprintf(line + used, room, "<?>");
+        else {
+            const LogArg &arg = record.args[next++];
+            bool narrow = (arg.type == LOGARG_INT || arg.type == LOGARG_UINT);
+            switch (conversion) {
+                case 'd': case 'i': {
+                    long long value = (arg.type == LOGARG_DOUBLE)? (long long)arg.d : narrow? (long long)(int)arg.i : arg.i;
+                    spec[n++] = 'l'; spec[n++] = 'l'; spec[n++] = conversion; spec[n] = '\0';
+                    written = snprintf(line + used, room, spec, value);
+                } break;
+                case 'u': case 'x': case 'X': case 'o': {
+                    unsigned long long value = (arg.type == LOGARG_DOUBLE)? (unsigned long long)arg.d : narrow? (unsigned long long)(unsigned)arg.i : arg.u;
+                    spec[n++] = 'l'; spec[n++] = 'l'; spec[n++] = conversion; spec[n] = '\0';
+                    written = snprintf(line + used, room, spec, value);
+                } break;
+                case 'c': {
+                    spec[n++] = 'c'; spec[n] = '\0';
+                    written = snprintf(line + used, room, spec, (int)arg.i);
+                } break;
+                case 'f': case 'F': case 'e': case 'E': case 'g': case 'G': case 'a': case 'A': {
+                    double value = (arg.type == LOGARG_DOUBLE)? arg.d : (arg.type == LOGARG_UINT64)? (double)arg.u : (double)arg.i;
+                    spec[n++] = conversion; spec[n] = '\0';
+                    written = snprintf(line + used, room, spec, value);
+                } break;
+                case 's': {
+                    const char *text = (arg.type == LOGARG_TEXT)? record.text + arg.i : "<?>";
+                    spec[n++] = 's'; spec[n] = '\0';
+                    written = snprintf(line + used, room, spec, text);
+                } break;
+                case 'p': {
+                    written = snprintf(line + used, room, "%p", arg.p);
+                } break;
+                default: written = snprintf(line + used, room, "<?>"); break;
+            }
+        }
+        if (written < 0) break;
+        used += (written < room)? written : room - 1;
+    }
+
+    line[used] = '\0';
+    return used;
+}
@@ -0,0 +1,155 @@
+/*******************************************************************************************
+*
+*   log - leveled logging for "Beat the boss!" that keeps formatting off the game thread
+*
+*   LOGT/LOGD/LOGI/LOGW/LOGE take a printf format and its arguments. Calls below
+*   LOG_MIN_LEVEL compile out to nothing (make LOG_MIN_LEVEL=n); the others check the
+*   runtime level and copy the format pointer, a timestamp and the raw arguments into a
+*   fixed record of a single producer, single consumer ring. A background thread started
+*   by LogStart() drains the ring, does the printf formatting and writes to the sink, so a
+*   log call on the tick costs a few stores instead of a synchronous stdout write.
+*
+*   The format must be a string literal (only its pointer is kept). String arguments are
+*   copied into the record, up to LOG_TEXT_BYTES per record. Conversions take any flags,
+*   width and precision but not '*'; the length modifiers are ignored, the argument's own
+*   type decides. Only one thread may log: the one that steps the World.
+*
+*   When the ring is full the record is dropped and counted, the game thread never waits.
+*   Without LogStart() (or after LogStop()) calls are formatted and written right away.
+*
+********************************************************************************************/
+
+#ifndef LOG_H
+#define LOG_H
+
+#include <stdio.h>
+
+enum LogSeverity {
+    LOGLEVEL_TRACE = 0,
+    LOGLEVEL_DEBUG,
+    LOGLEVEL_INFO,
+    LOGLEVEL_WARN,
+    LOGLEVEL_ERROR,
+    LOGLEVEL_NONE
+};
+
+// Calls below this level are not compiled in; trace is off unless asked for
+#if !defined(LOG_MIN_LEVEL)
+    #define LOG_MIN_LEVEL   LOGLEVEL_DEBUG
+#endif
+
+#define LOG_RING_RECORDS    4096        // power of two
+#define LOG_MAX_ARGS        8
+#define LOG_TEXT_BYTES      64          // copied string arguments per record
+#define LOG_LINE_BYTES      512         // longest formatted line, longer ones are cut
+
+//----------------------------------------------------------------------------------
+// Types and Structures Definition
+//----------------------------------------------------------------------------------
+enum LogArgType {
+    LOGARG_INT = 0,         // int and smaller, sign extended
+    LOGARG_UINT,            // unsigned int and smaller
+    LOGARG_INT64,
+    LOGARG_UINT64,
+    LOGARG_DOUBLE,
+    LOGARG_TEXT,            // offset in the record's text
+    LOGARG_POINTER
+};
+
+struct LogArg {
+    int type;               // LogArgType
+    union {
+        long long i;
+        unsigned long long u;
+        double d;
+        const void *p;
+    };
+};
+
+struct LogRecord {
+    const char *format;
+    double time;            // seconds since the first log call
+    int level;
+    int argc;
+    int textUsed;
+    LogArg args[LOG_MAX_ARGS];
+    char text[LOG_TEXT_BYTES];
+};
+
+//------------------------------------------------------------------------------------
+// Module Functions Declaration
+//------------------------------------------------------------------------------------
+extern int logLevel;                        // runtime filter, LOGLEVEL_INFO by default
+
+void LogSetLevel(int level);
+bool LogStart(FILE *sink);                  // Drain the ring on a background thread into sink (NULL: stdout)
+void LogFlush(void);                        // Wait until everything logged so far is written
+void LogStop(void);                         // Flush, stop the thread, log synchronously again
+long LogDropped(void);                      // Records lost to a full ring since the start
+const char *LogLevelName(int level);
+int LogFormat(const LogRecord &record, char *line, int size);   // printf the record into line, returns its length
+
+LogRecord *LogBegin(int level, const char *format);     // Next free record, NULL when the ring is full
+void LogCommit(LogRecord *record);                      // Hand the record to the sink
+
+//------------------------------------------------------------------------------------
+// Argument capture (no formatting, the sink thread does it)
+//------------------------------------------------------------------------------------
+inline void LogPutInt(LogRecord &r, long long value, int type) { r.args[r.argc].type = type; r.args[r.argc++].i = value; }
+
+inline void LogPut(LogRecord &r, bool value) { LogPutInt(r, value, LOGARG_INT); }
+inline void LogPut(LogRecord &r, char value) { LogPutInt(r, value, LOGARG_INT); }
+inline void LogPut(LogRecord &r, signed char value) { LogPutInt(r, value, LOGARG_INT); }
+inline void LogPut(LogRecord &r, unsigned char value) { LogPutInt(r, value, LOGARG_UINT); }
+inline void LogPut(LogRecord &r, short value) { LogPutInt(r, value, LOGARG_INT); }
+inline void LogPut(LogRecord &r, unsigned short value) { LogPutInt(r, value, LOGARG_UINT); }
+inline void LogPut(LogRecord &r, int value) { LogPutInt(r, value, LOGARG_INT); }
+inline void LogPut(LogRecord &r, unsigned int value) { LogPutInt(r, value, LOGARG_UINT); }
+inline void LogPut(LogRecord &r, long value) { LogPutInt(r, value, (sizeof(long) > sizeof(int))? LOGARG_INT64 : LOGARG_INT); }
+inline void LogPut(LogRecord &r, unsigned long value) { LogPutInt(r, (long long)value, (sizeof(long) > sizeof(int))? LOGARG_UINT64 : LOGARG_UINT); }
+inline void LogPut(LogRecord &r, long long value) { LogPutInt(r, value, LOGARG_INT64); }
+inline void LogPut(LogRecord &r, unsigned long long value) { LogPutInt(r, (long long)value, LOGARG_UINT64); }
+inline void LogPut(LogRecord &r, double value) { r.args[r.argc].type = LOGARG_DOUBLE; r.args[r.argc++].d = value; }
+inline void LogPut(LogRecord &r, float value) { LogPut(r, (double)value); }
+inline void LogPut(LogRecord &r, const void *value) { r.args[r.argc].type = LOGARG_POINTER; r.args[r.argc++].p = value; }
+
+inline void LogPut(LogRecord &r, const char *value)
+{
+    LogArg &arg = r.args[r.argc++];
+    arg.type = LOGARG_TEXT;
+    arg.i = (r.textUsed < LOG_TEXT_BYTES)? r.textUsed : LOG_TEXT_BYTES - 1;     // full: the last terminator
+    if (value == NULL) value = "(null)";
+    while (*value && r.textUsed < LOG_TEXT_BYTES - 1) r.text[r.textUsed++] = *value++;
+    if (r.textUsed < LOG_TEXT_BYTES) r.text[r.textUsed++] = '\0';
+}
+inline void LogPut(LogRecord &r, char *value) { LogPut(r, (const char *)value); }
+
+inline void LogPutAll(LogRecord &r) { }
+
+template <class T, class... Rest>
+inline void LogPutAll(LogRecord &r, const T &value, const Rest &... rest)
+{
+    LogPut(r, value);
+    LogPutAll(r, rest...);
+}
+
+template <class... Args>
+inline void LogWrite(int level, const char *format, const Args &... args)
+{
+    static_assert(sizeof...(Args) <= LOG_MAX_ARGS, "too many log arguments");
+
+    LogRecord *record = LogBegin(level, format);
+    if (record == NULL) return;
+    LogPutAll(*record, args...);
+    LogCommit(record);
+}
+
+#define LOG_AT(level, ...)  do { if ((level) >= LOG_MIN_LEVEL && (level) >= logLevel) LogWrite(level, __VA_ARGS__); } while (0)
+
+#define LOGT(...)           LOG_AT(LOGLEVEL_TRACE, __VA_ARGS__)
+#define LOGD(...)           LOG_AT(LOGLEVEL_DEBUG, __VA_ARGS__)
+#define LOGI(...)           LOG_AT(LOGLEVEL_INFO, __VA_ARGS__)
+#define LOGW(...)           LOG_AT(LOGLEVEL_WARN, __VA_ARGS__)
+#define LOGE(...)           LOG_AT(LOGLEVEL_ERROR, __VA_ARGS__)
+
+#endif // LOG_H
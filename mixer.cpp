@@ -0,0 +1,207 @@
+/*******************************************************************************************
+*
+*   mixer - software sound mixer with a fixed voice pool and rate limited sound events
+*
+********************************************************************************************/
+
+#include "mixer.h"
+#include <string.h>
+
+#define NEVER_STARTED   -1.0e9
+
+Mixer::Mixer()
+{
+    memset(&stats, 0, sizeof(stats));
+    masterVolume = 1.0f;
+    memset(sounds, 0, sizeof(sounds));
+    soundCount = 0;
+    memset(events, 0, sizeof(events));
+    for (int e = 0; e < MIXER_MAX_EVENTS; e++) lastStart[e] = NEVER_STARTED;
+    eventCount = 0;
+    queued = 0;
+    accumulator.resize(MIXER_CHUNK_FRAMES*MIXER_CHANNELS);
+    stopAll();
+}
+
+int Mixer::addSound(const MixerSound &sound)
+{
+    if (soundCount == MIXER_MAX_SOUNDS) return -1;
+    sounds[soundCount] = sound;
+    return soundCount++;
+}
+
+void Mixer::setSound(int sound, const MixerSound &data)
+{
+    if (sound < 0 || sound >= soundCount) return;
+
+    // Voices still reading the old samples are cut
+    for (int v = 0; v < MIXER_VOICES; v++) {
+        if (voices[v].event >= 0 && voices[v].sound == sound) voices[v].event = -1;
+    }
+    sounds[sound] = data;
+}
+
+int Mixer::addEvent(const SoundEvent &event)
+{
+    if (eventCount == MIXER_MAX_EVENTS) return -1;
+    events[eventCount] = event;
+    if (events[eventCount].maxVoices < 1) events[eventCount].maxVoices = 1;
+    return eventCount++;
+}
+
+void Mixer::trigger(int event)
+{
+    if (event < 0 || event >= eventCount) return;
+
+    stats.triggered++;
+    if (queued == MIXER_QUEUE_SIZE) {
+        stats.dropped++;
+        return;
+    }
+    queue[queued++] = event;
+}
+
+void Mixer::update(double now)
+{
+    bool started[MIXER_MAX_EVENTS] = { };
+
+    for (int q = 0; q < queued; q++) {
+        int event = queue[q];
+        if (started[event]) {
+            stats.coalesced++;
+            continue;
+        }
+        started[event] = true;
+
+        if (now - lastStart[event] < events[event].cooldown) {
+            stats.rateLimited++;
+            continue;
+        }
+        start(event, now);
+    }
+    queued = 0;
+}
+
+void Mixer::start(int event, double now)
+{
+    const SoundEvent &info = events[event];
+    const MixerSound &sound = sounds[info.sound];
+    if (sound.samples == NULL || sound.frames <= 0) {
+        stats.dropped++;    // not loaded (yet)
+        return;
+    }
+
+    int voice = pickVoice(event, info.priority);
+    if (voice < 0) {
+        stats.dropped++;
+        return;
+    }
+    if (voices[voice].event >= 0) stats.stolen++;
+
+    Voice &v = voices[voice];
+    v.event = event;
+    v.sound = info.sound;
+    v.priority = info.priority;
+    v.startTime = now;
+    v.position = 0.0f;
+    v.step = (float)sound.sampleRate/MIXER_SAMPLE_RATE;
+    v.volume = info.volume;
+
+    lastStart[event] = now;
+    stats.played++;
+}
+
+int Mixer::pickVoice(int event, int priority)
+{
+    // Over its own limit: restart the oldest instance of the event
+    int instances = 0, oldestInstance = -1;
+    for (int v = 0; v < MIXER_VOICES; v++) {
+        if (voices[v].event != event) continue;
+        instances++;
+        if (oldestInstance < 0 || voices[v].startTime < voices[oldestInstance].startTime) oldestInstance = v;
+    }
+    if (instances >= events[event].maxVoices) return oldestInstance;
+
+    int victim = -1;
+    for (int v = 0; v < MIXER_VOICES; v++) {
+        if (voices[v].event < 0) return v;
+        if (victim < 0 || voices[v].priority < voices[victim].priority ||
+            (voices[v].priority == voices[victim].priority && voices[v].startTime < voices[victim].startTime)) victim = v;
+    }
+
+    return (voices[victim].priority <= priority)? victim : -1;
+}
+
+void Mixer::mix(short *out, int frames)
+{
+    while (frames > 0) {
+        int chunk = (frames < MIXER_CHUNK_FRAMES)? frames : MIXER_CHUNK_FRAMES;
+        int *acc = accumulator.data();
+        memset(acc, 0, chunk*MIXER_CHANNELS*sizeof(int));
+
+        for (int v = 0; v < MIXER_VOICES; v++) {
+            Voice &voice = voices[v];
+            if (voice.event < 0) continue;
+
+            const MixerSound &sound = sounds[voice.sound];
+            int gain = (int)(voice.volume*masterVolume*256.0f);     // 8.8 fixed point
+            int right = (sound.channels > 1)? 1 : 0;                // mono goes to both sides
+            for (int f = 0; f < chunk; f++) {
+                int frame = (int)voice.position;
+                if (frame >= sound.frames) {
+                    voice.event = -1;
+                    break;
+                }
+                const short *sample = sound.samples + frame*sound.channels;
+                acc[2*f] += sample[0]*gain;
+                acc[2*f + 1] += sample[right]*gain;
+                voice.position += voice.step;
+            }
+        }
+
+        for (int s = 0; s < chunk*MIXER_CHANNELS; s++) {
+            int value = acc[s] >> 8;
+            out[s] = (short)((value > 32767)? 32767 : (value < -32768)? -32768 : value);
+        }
+
+        out += chunk*MIXER_CHANNELS;
+        frames -= chunk;
+    }
+}
+
+void Mixer::stopAll()
+{
+    for (int v = 0; v < MIXER_VOICES; v++) {
+        memset(&voices[v], 0, sizeof(Voice));
+        voices[v].event = -1;
+    }
+}
+
+int Mixer::activeVoices() const
+{
+    int active = 0;
+    for (int v = 0; v < MIXER_VOICES; v++) active += (voices[v].event >= 0);
+    return active;
+}
+
+NullAudioOutput::NullAudioOutput(Mixer *target)
+{
+    framesMixed = 0;
+    mixer = target;
+    pending = 0.0;
+    buffer.resize(MIXER_CHUNK_FRAMES*MIXER_CHANNELS);
+}
+
+void NullAudioOutput::advance(double seconds)
+{
+    pending += seconds*MIXER_SAMPLE_RATE;
+    int frames = (int)pending;
+    pending -= frames;
+
+    while (frames > 0) {
+        int chunk = (frames < MIXER_CHUNK_FRAMES)? frames : MIXER_CHUNK_FRAMES;
+        mixer->mix(buffer.data(), chunk);
+        framesMixed += chunk;
+        frames -= chunk;
+    }
+}
@@ -0,0 +1,120 @@
+/*******************************************************************************************
+*
+*   mixer - software sound mixer with a fixed voice pool and rate limited sound events
+*
+*   Gameplay only triggers events ("player shot", "boss volley"). trigger() just queues
+*   them; update() drains the queue once per frame:
+*
+*       - triggers of one event in the same update are coalesced into one voice
+*       - an event inside its cooldown since it last started is dropped (rate limited)
+*       - an event with maxVoices instances playing restarts its oldest one
+*       - with every voice busy, the lowest priority (then oldest) voice is stolen if
+*         its priority is not above the event's, otherwise the event is dropped
+*
+*   mix() sums the voices into interleaved 16-bit stereo at MIXER_SAMPLE_RATE. Where the
+*   samples go is up to the caller: an audio stream in the game, NullAudioOutput for
+*   headless runs, which mixes in real time steps and throws the result away, so the
+*   whole cost can be measured without a device. No raylib in here, and no allocation
+*   after construction.
+*
+********************************************************************************************/
+
+#ifndef MIXER_H
+#define MIXER_H
+
+#include <vector>
+using namespace std;
+
+#define MIXER_SAMPLE_RATE   44100
+#define MIXER_CHANNELS      2           // output is interleaved stereo
+#define MIXER_VOICES        16
+#define MIXER_MAX_SOUNDS    32
+#define MIXER_MAX_EVENTS    32
+#define MIXER_QUEUE_SIZE    64          // triggers kept between two updates, the rest are dropped
+#define MIXER_CHUNK_FRAMES  1024        // frames mixed per pass over the voices
+
+// 16-bit PCM, mono or interleaved stereo, at any rate; not copied, must outlive the mixer
+struct MixerSound {
+    const short *samples;
+    int frames;
+    int channels;
+    int sampleRate;
+};
+
+struct SoundEvent {
+    int sound;
+    int priority;       // higher steals lower
+    float cooldown;     // seconds between two starts
+    float volume;
+    int maxVoices;      // instances of this event playing at once
+};
+
+struct MixerStats {
+    long triggered;
+    long played;
+    long coalesced;     // same event triggered again before the update
+    long rateLimited;   // inside the cooldown
+    long stolen;        // a playing voice was cut for it
+    long dropped;       // no voice to take, or the queue was full
+};
+
+class Mixer {
+public:
+    MixerStats stats;
+    float masterVolume;
+
+    Mixer();
+
+    int addSound(const MixerSound &sound);      // sound id, -1 if full; samples may still be NULL
+    void setSound(int sound, const MixerSound &data);   // once the samples are loaded
+    int addEvent(const SoundEvent &event);      // event id, -1 if full
+
+    void trigger(int event);
+    void update(double now);                    // now: seconds, any clock that only goes forward
+    void mix(short *out, int frames);
+    void stopAll();
+
+    int activeVoices() const;
+
+private:
+    struct Voice {
+        int event;          // -1 when free
+        int sound;
+        int priority;
+        double startTime;
+        float position;     // in source frames
+        float step;         // source frames per output frame
+        float volume;
+    };
+
+    MixerSound sounds[MIXER_MAX_SOUNDS];
+    int soundCount;
+    SoundEvent events[MIXER_MAX_EVENTS];
+    double lastStart[MIXER_MAX_EVENTS];
+    int eventCount;
+
+    int queue[MIXER_QUEUE_SIZE];
+    int queued;
+
+    Voice voices[MIXER_VOICES];
+    vector<int> accumulator;    // MIXER_CHUNK_FRAMES*MIXER_CHANNELS, sums before clipping
+
+    void start(int event, double now);
+    int pickVoice(int event, int priority);     // -1 if nothing may be taken
+};
+
+// Headless output: pulls from the mixer as a device would, keeps nothing
+class NullAudioOutput {
+public:
+    long framesMixed;
+
+    NullAudioOutput(Mixer *mixer);
+    void advance(double seconds);   // mix the frames a device would have played by now
+
+private:
+    Mixer *mixer;
+    double pending;                 // fraction of a frame carried to the next call
+    vector<short> buffer;
+};
+
+#endif // MIXER_H
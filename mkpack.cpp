@@ -0,0 +1,43 @@
+/*******************************************************************************************
+*
+*   mkpack - build the asset pack the game maps at startup
+*
+*   Decodes every listed file once (PNG to RGBA8, WAV/OGG to PCM, anything else as is)
+*   into one archive. Without arguments it packs the game's assets into assets.pak; the
+*   sprite atlas has to be packed first (make assets.pak does both).
+*
+*   Usage: mkpack [pack file...]
+*
+********************************************************************************************/
+
+#include "assetpack.h"
+#include "atlas.h"
+#include <stdio.h>
+
+static const char *gameAssets[] = {
+    ATLAS_IMAGE_PATH,
+    ATLAS_TABLE_PATH,
+    "texture/TileableWall.png",
+    "texture/radio/player.wav",
+    "texture/radio/boss.wav"
+};
+
+int main(int argc, char **argv)
+{
+    const char *packPath = (argc > 1)? argv[1] : ASSET_PACK_PATH;
+    const char **files = gameAssets;
+    int count = sizeof(gameAssets)/sizeof(gameAssets[0]);
+    if (argc > 2) {
+        files = (const char **)(argv + 2);
+        count = argc - 2;
+    }
+
+    SetTraceLogLevel(LOG_WARNING);
+    if (!BuildAssetPack(packPath, files, count)) {
+        printf("mkpack: could not build %s\n", packPath);
+        return 1;
+    }
+    printf("mkpack: %d assets packed into %s\n", count, packPath);
+
+    return 0;
+}
@@ -0,0 +1,80 @@
+/*******************************************************************************************
+*
+*   pattern - boss attack patterns as data, compiled into flat volley tables
+*
+********************************************************************************************/
+
+#include "pattern.h"
+#include "world.h"
+#include "trig.h"
+#include <float.h>
+#include <math.h>
+
+const PatternDesc defaultBossPatterns[] = {
+    // Aimed shot, bigger every 200 ticks, at the first player on multiples of 100
+    { "aimed",  1, 3, 3,  0, 0,  1, 0.0f,  0.0f, 0.0f, 1.0f,  10.0f, 200, 20.0f, YELLOW,    10, AIM_PLAYER, 100 },
+    // Radial burst, 0 to 360 degrees both included like it always was
+    { "radial", 0, 1, 3,  0, 0, 19, 0.0f, 20.0f, 0.0f, 1.0f,  10.0f,   0,  0.0f, DARKBROWN, 10, AIM_FIXED,    0 },
+};
+const int defaultBossPatternCount = sizeof(defaultBossPatterns)/sizeof(defaultBossPatterns[0]);
+
+void PatternSchedule::compile(const PatternDesc *table, int count, const SimConfig &config)
+{
+    patterns.clear();
+    shotX.clear();
+    shotY.clear();
+
+    int maxCount = 0;
+    for (int p = 0; p < count; p++) {
+        const PatternDesc &desc = table[p];
+        if (desc.count <= 0 || desc.hpParts <= 0) continue;
+
+        CompiledPattern c;
+        c.desc = &desc;
+        c.hpMin = (desc.hpFrom <= 0)? -FLT_MAX : config.bossMaxHp*desc.hpFrom/desc.hpParts;
+        c.hpMax = (desc.hpTo >= desc.hpParts)? FLT_MAX : config.bossMaxHp*desc.hpTo/desc.hpParts;
+        c.cadence = (desc.cadence > 0)? desc.cadence : config.volleyInterval;
+        c.offset = desc.offset % c.cadence;
+        c.count = desc.count;
+        c.slots = 1;
+        if (desc.spin != 0.0f && config.attackWindow > 0) {
+            c.slots = (config.attackWindow - 1)/c.cadence + 1;
+            if (c.slots > PATTERN_MAX_SLOTS) c.slots = PATTERN_MAX_SLOTS;
+        }
+        c.firstShot = (int)shotX.size();
+        c.speed = config.meteorSpeed*desc.speed;
+        c.radius = fminf(desc.radius, METEOR_MAX_RADIUS);
+        c.bigRadius = fminf(desc.bigRadius, METEOR_MAX_RADIUS);
+
+        // The only trig of the patterns, once per meteor of every row (whole degrees from the table)
+        for (int slot = 0; slot < c.slots; slot++) {
+            for (int k = 0; k < desc.count; k++) {
+                float angle = desc.angle + k*desc.spread + slot*desc.spin;
+                if (desc.aim == AIM_FIXED) {
+                    shotX.push_back(c.speed * angleSin(angle));
+                    shotY.push_back(- c.speed * angleCos(angle));
+                }
+                else {
+                    shotX.push_back(angleCos(angle));
+                    shotY.push_back(angleSin(angle));
+                }
+            }
+        }
+
+        patterns.push_back(c);
+        if (desc.count > maxCount) maxCount = desc.count;
+    }
+
+    if ((int)volleyX.size() < maxCount) {
+        volleyX.resize(maxCount);
+        volleyY.resize(maxCount);
+    }
+}
+
+int PatternSchedule::row(int p, int tick, int attackCycle) const
+{
+    const CompiledPattern &c = patterns[p];
+    if (c.slots == 1) return 0;
+
+    return ((tick % attackCycle)/c.cadence) % c.slots;
+}
@@ -0,0 +1,102 @@
+/*******************************************************************************************
+*
+*   pattern - boss attack patterns as data, compiled into flat volley tables
+*
+*   A PatternDesc says what a boss fires (how many meteors, over which angles, how fast and
+*   how big), how often (cadence within the attack window) and when (an HP phase). The
+*   table is compiled once per match against the SimConfig: every volley a pattern can
+*   fire gets its meteor velocities worked out up front, one row per volley in flat x/y
+*   arrays, so the tick only copies them into the meteor pool (no trig per meteor). Aimed
+*   patterns store the turn of each meteor relative to the aim instead; the tick finds
+*   the aim once per volley and rotates with a multiply-add.
+*
+*   Angles are degrees, 0 is up and they grow clockwise, like the boss rotation.
+*
+********************************************************************************************/
+
+#ifndef PATTERN_H
+#define PATTERN_H
+
+#include "simtypes.h"
+#include <vector>
+using namespace std;
+
+struct SimConfig;
+
+// What the angles of a pattern are relative to
+enum PatternAim {
+    AIM_FIXED = 0,          // the arena: angle 0 is straight up
+    AIM_PLAYER              // the direction from the boss to the targeted player
+};
+
+// Spin makes every volley of a window a different row, up to this many
+#define PATTERN_MAX_SLOTS   64
+
+struct PatternDesc {
+    const char *name;
+
+    // HP phase: boss max HP split in hpParts, the pattern fires while the boss is within
+    // parts [hpFrom, hpTo). 0 and hpParts are open ended, pinned or overkilled HP still
+    // has a phase
+    int hpFrom;
+    int hpTo;
+    int hpParts;
+
+    int cadence;            // ticks between volleys, 0: the SimConfig volleyInterval
+    int offset;             // fires on ticks where tick % cadence == offset
+    int count;              // meteors per volley
+    float angle;            // of the first meteor
+    float spread;           // between consecutive meteors
+    float spin;             // the whole volley turns by this much every volley of a window
+    float speed;            // times the SimConfig meteorSpeed
+
+    float radius;           // at most METEOR_MAX_RADIUS, larger ones are clamped
+    int bigEvery;           // volleys on multiples of this tick use bigRadius (0: never)
+    float bigRadius;
+    Color color;
+    int damage;
+
+    int aim;                // PatternAim
+    int targetEvery;        // AIM_PLAYER: first player on multiples of this tick, else the others in turn (0: never the first)
+};
+
+// One pattern after compilation, thresholds and speeds resolved
+struct CompiledPattern {
+    const PatternDesc *desc;
+    float hpMin;            // fires while hpMin <= hp < hpMax
+    float hpMax;
+    int cadence;
+    int offset;
+    int count;
+    int slots;              // rows of velocities, one per volley of a window when spinning
+    int firstShot;          // row 0 in the shot arrays
+    float speed;
+    float radius;           // clamped to METEOR_MAX_RADIUS, the reach of the collision grid
+    float bigRadius;
+};
+
+class PatternSchedule {
+public:
+    vector<CompiledPattern> patterns;
+
+    // Per meteor of every row: the velocity for AIM_FIXED, the cos/sin of the turn from
+    // the aim for AIM_PLAYER
+    vector<float> shotX;
+    vector<float> shotY;
+
+    // Scratch for the aimed velocities of one volley
+    vector<float> volleyX;
+    vector<float> volleyY;
+
+    // Keeps the vectors' storage, so compiling again for the next match does not allocate
+    void compile(const PatternDesc *table, int count, const SimConfig &config);
+
+    // Row of the volley fired at tick by pattern p
+    int row(int p, int tick, int attackCycle) const;
+};
+
+// The boss of "Beat the boss!": aimed shots, a radial burst below a third of its HP
+extern const PatternDesc defaultBossPatterns[];
+extern const int defaultBossPatternCount;
+
+#endif // PATTERN_H
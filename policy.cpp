@@ -0,0 +1,138 @@
+/*******************************************************************************************
+*
+*   policy - scripted and AI players for headless matches
+*
+********************************************************************************************/
+
+#include "policy.h"
+#include <string.h>
+
+static const char *policyNames[POLICY_COUNT] = { "scripted", "aim" };
+
+// Deterministic noise in [0, 1) per match, tick and player
+static float PolicyNoise(const World &world, int player)
+{
+    uint32_t h = world.seed*0x9e3779b9u ^ (uint32_t)world.framesCounter*0x85ebca6bu ^ (uint32_t)(player + 1)*0xc2b2ae35u;
+    h ^= h >> 16;
+    h *= 0x7feb352du;
+    h ^= h >> 15;
+    h *= 0x846ca68bu;
+    h ^= h >> 16;
+    return (h >> 8)*(1.0f/16777216.0f);
+}
+
+static unsigned char ScriptedButtons(const World &world, int i)
+{
+    int phase = (world.framesCounter / 40 + i) % 4;
+    unsigned char buttons = (unsigned char)(1 << phase);
+    if ((world.framesCounter + i*3) % POLICY_FIRE_INTERVAL == 0) buttons |= INPUT_FIRE;
+    return buttons;
+}
+
+// Direction that steps out of the path of the closest meteor heading this way, -1 if none
+static int DodgeDirection(const World &world, Vector2 position)
+{
+    const ProjectilePool &meteors = world.meteors;
+    int threat = -1;
+    float threatDistance = POLICY_DANGER_RADIUS;
+
+    for (int m = 0; m < meteors.size(); m++) {
+        if (!meteors.active(m)) continue;
+        float dx = position.x - meteors.x[m];
+        float dy = position.y - meteors.y[m];
+        bool closing = dx*meteors.vx[m] + dy*meteors.vy[m] > 0.0f;
+        if (!closing) continue;
+
+        // Most meteors are far: rule them out on the squared distance, with a pixel to spare
+        // so rounding never drops one the exact test would keep
+        float reach = threatDistance + meteors.r[m] + 1.0f;
+        if (dx*dx + dy*dy > reach*reach) continue;
+
+        float distance = getDistance(position.x, position.y, meteors.x[m], meteors.y[m]) - meteors.r[m];
+        if (distance < threatDistance) {
+            threat = m;
+            threatDistance = distance;
+        }
+    }
+    if (threat < 0) return -1;
+
+    // Sidestep across the meteor's path, away from its side, and away from the walls
+    if (fabsf(meteors.vx[threat]) > fabsf(meteors.vy[threat])) {
+        int dir = (position.y < meteors.y[threat])? DIR_UP : DIR_DOWN;
+        if (dir == DIR_UP && position.y < POLICY_DANGER_RADIUS) dir = DIR_DOWN;
+        if (dir == DIR_DOWN && position.y > screenHeight - POLICY_DANGER_RADIUS) dir = DIR_UP;
+        return dir;
+    }
+    int dir = (position.x < meteors.x[threat])? DIR_LEFT : DIR_RIGHT;
+    if (dir == DIR_LEFT && position.x < POLICY_DANGER_RADIUS) dir = DIR_RIGHT;
+    if (dir == DIR_RIGHT && position.x > screenWidth - POLICY_DANGER_RADIUS) dir = DIR_LEFT;
+    return dir;
+}
+
+static unsigned char AimButtons(const World &world, int i, float skill)
+{
+    Vector2 position = world.players.position[i];
+    if (PolicyNoise(world, i) >= skill) return 0;     // hesitates this tick
+
+    int dodge = DodgeDirection(world, position);
+    if (dodge >= 0) return (unsigned char)(1 << dodge);
+
+    int target = -1;
+    float targetDistanceSq = 0.0f;
+    for (int b = 0; b < world.bosses.size(); b++) {
+        float distanceSq = getDistanceSq(position.x, position.y, world.bosses.position[b].x, world.bosses.position[b].y);
+        if (target < 0 || distanceSq < targetDistanceSq) {
+            target = b;
+            targetDistanceSq = distanceSq;
+        }
+    }
+    if (target < 0) return 0;
+
+    // Shoot along the axis the boss is farther on, line up on the other one first
+    float dx = world.bosses.position[target].x - position.x;
+    float dy = world.bosses.position[target].y - position.y;
+    bool aligned;
+    int lineUp, face;
+    if (fabsf(dy) >= fabsf(dx)) {
+        aligned = fabsf(dx) <= POLICY_ALIGN_SLACK;
+        lineUp = (dx > 0)? DIR_RIGHT : DIR_LEFT;
+        face = (dy < 0)? DIR_UP : DIR_DOWN;
+    }
+    else {
+        aligned = fabsf(dy) <= POLICY_ALIGN_SLACK;
+        lineUp = (dy > 0)? DIR_DOWN : DIR_UP;
+        face = (dx > 0)? DIR_RIGHT : DIR_LEFT;
+    }
+
+    // Opposite directions are two apart in DIR_* order
+    if (targetDistanceSq < POLICY_KEEP_DISTANCE*POLICY_KEEP_DISTANCE) return (unsigned char)(1 << ((face + 2) % 4));
+    if (!aligned) return (unsigned char)(1 << lineUp);
+    if (world.players.direction[i] != face) return (unsigned char)(1 << face);    // a one tick tap turns without walking far
+    if ((world.framesCounter + i*3) % POLICY_FIRE_INTERVAL == 0) return INPUT_FIRE;
+    return 0;
+}
+
+InputFrame PolicyInput(int policy, const World &world, float skill)
+{
+    InputFrame input = { };
+
+    for (int i = 0; i < world.players.size(); i++) {
+        if (policy == POLICY_AIM) input.player[i] = (world.players.hp[i] > 0)? AimButtons(world, i, skill) : 0;
+        else input.player[i] = ScriptedButtons(world, i);
+    }
+
+    return input;
+}
+
+const char *PolicyName(int policy)
+{
+    return policyNames[policy];
+}
+
+int PolicyFromName(const char *name)
+{
+    for (int policy = 0; policy < POLICY_COUNT; policy++) {
+        if (strcmp(name, policyNames[policy]) == 0) return policy;
+    }
+    return -1;
+}
@@ -0,0 +1,37 @@
+/*******************************************************************************************
+*
+*   policy - scripted and AI players for headless matches
+*
+*   A policy looks at the World and produces the InputFrame of the next tick, the same
+*   bits a keyboard would. Policies are pure functions of the world state, so matches
+*   driven by them stay deterministic.
+*
+*       POLICY_SCRIPTED     wander on a fixed cycle, fire every few ticks (soak's player)
+*       POLICY_AIM          dodge incoming meteors, line up with the nearest boss, face it
+*                           and fire; skill is the chance to act on any given tick, the
+*                           hesitation is drawn from a hash of the match seed and tick
+*
+********************************************************************************************/
+
+#ifndef POLICY_H
+#define POLICY_H
+
+#include "world.h"
+
+enum InputPolicy {
+    POLICY_SCRIPTED = 0,
+    POLICY_AIM,
+    POLICY_COUNT
+};
+
+#define POLICY_FIRE_INTERVAL    6       // ticks between two shots
+#define POLICY_DANGER_RADIUS    70.0f   // meteors closer than this and closing in get dodged
+#define POLICY_ALIGN_SLACK      12.0f   // off axis distance still good enough to shoot
+#define POLICY_KEEP_DISTANCE    110.0f  // back off when the boss gets closer than this
+#define POLICY_DEFAULT_SKILL    0.5f
+
+InputFrame PolicyInput(int policy, const World &world, float skill = POLICY_DEFAULT_SKILL);
+const char *PolicyName(int policy);
+int PolicyFromName(const char *name);   // -1 if unknown
+
+#endif // POLICY_H
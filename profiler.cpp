@@ -0,0 +1,154 @@
+/*******************************************************************************************
+*
+*   profiler - frame phase timers for "Beat the boss!"
+*
+********************************************************************************************/
+
+#include "profiler.h"
+
+#if defined(ENABLE_PROFILER)
+
+#include <stdio.h>
+#include <algorithm>
+#include <chrono>
+#include <vector>
+using namespace std;
+
+//----------------------------------------------------------------------------------
+// Types and Structures Definition
+//----------------------------------------------------------------------------------
+struct TraceEvent {
+    int phase;              // phase index, or -1 for a counter sample
+    double start;           // microseconds
+    double duration;
+    ProfileCounts counts;   // counter samples only
+};
+
+struct PhaseWindow {
+    float samples[PROFILE_WINDOW];
+    int next;
+    int count;
+};
+
+//------------------------------------------------------------------------------------
+// Global Variables Declaration
+//------------------------------------------------------------------------------------
+static const char *phaseNames[PHASE_COUNT] = { "boss", "player", "bullet", "meteor", "collision", "audio", "draw" };
+
+static const chrono::steady_clock::time_point profilerEpoch = chrono::steady_clock::now();
+static PhaseWindow windows[PHASE_COUNT];
+static double phaseTotals[PHASE_COUNT];
+static ProfileCounts lastCounts;
+static vector<TraceEvent> traceEvents;
+static bool traceEnabled = true;
+
+//------------------------------------------------------------------------------------
+// Module Functions Definitions
+//------------------------------------------------------------------------------------
+static void PushTraceEvent(const TraceEvent &event)
+{
+    if (!traceEnabled) return;
+    if (traceEvents.capacity() == 0) traceEvents.reserve(PROFILE_MAX_EVENTS);
+    if (traceEvents.size() < PROFILE_MAX_EVENTS) traceEvents.push_back(event);
+}
+
+double ProfilerNow(void)
+{
+    return chrono::duration<double, micro>(chrono::steady_clock::now() - profilerEpoch).count();
+}
+
+void ProfilerRecord(int phase, double start, double end)
+{
+    PhaseWindow &window = windows[phase];
+    window.samples[window.next] = (float)(end - start);
+    window.next = (window.next + 1) % PROFILE_WINDOW;
+    if (window.count < PROFILE_WINDOW) window.count++;
+    phaseTotals[phase] += end - start;
+
+    TraceEvent event = { phase, start, end - start, lastCounts };
+    PushTraceEvent(event);
+}
+
+void ProfilerSetCounts(int bosses, int players, int meteors, int bullets)
+{
+    lastCounts.bosses = bosses;
+    lastCounts.players = players;
+    lastCounts.meteors = meteors;
+    lastCounts.bullets = bullets;
+
+    TraceEvent event = { -1, ProfilerNow(), 0.0, lastCounts };
+    PushTraceEvent(event);
+}
+
+ProfileCounts ProfilerGetCounts(void)
+{
+    return lastCounts;
+}
+
+PhaseStats ProfilerGetStats(int phase)
+{
+    PhaseStats stats = { 0.0f, 0.0f, 0.0f, 0 };
+    const PhaseWindow &window = windows[phase];
+    if (window.count == 0) return stats;
+
+    float sorted[PROFILE_WINDOW];
+    copy(window.samples, window.samples + window.count, sorted);
+    sort(sorted, sorted + window.count);
+
+    stats.p50 = sorted[(window.count - 1)*50/100];
+    stats.p99 = sorted[(window.count - 1)*99/100];
+    stats.max = sorted[window.count - 1];
+    stats.samples = window.count;
+    return stats;
+}
+
+double ProfilerGetTotal(int phase)
+{
+    return phaseTotals[phase];
+}
+
+void ProfilerEnableTrace(bool enable)
+{
+    traceEnabled = enable;
+}
+
+void ProfilerReset(void)
+{
+    for (int phase = 0; phase < PHASE_COUNT; phase++) {
+        windows[phase].next = 0;
+        windows[phase].count = 0;
+        phaseTotals[phase] = 0.0;
+    }
+    traceEvents.clear();
+}
+
+const char *ProfilerPhaseName(int phase)
+{
+    return phaseNames[phase];
+}
+
+bool ProfilerWriteTrace(const char *fileName)
+{
+    FILE *file = fopen(fileName, "w");
+    if (file == NULL) return false;
+
+    fprintf(file, "{\"traceEvents\":[\n");
+    for (size_t i = 0; i < traceEvents.size(); i++) {
+        const TraceEvent &event = traceEvents[i];
+        const char *separator = (i + 1 < traceEvents.size())? "," : "";
+        if (event.phase >= 0) {
+            fprintf(file, "{\"name\":\"%s\",\"ph\":\"X\",\"ts\":%.3f,\"dur\":%.3f,\"pid\":1,\"tid\":1}%s\n",
+                    phaseNames[event.phase], event.start, event.duration, separator);
+        }
+        else {
+            fprintf(file, "{\"name\":\"entities\",\"ph\":\"C\",\"ts\":%.3f,\"pid\":1,\"args\":{\"bosses\":%d,\"players\":%d,\"meteors\":%d,\"bullets\":%d}}%s\n",
+                    event.start, event.counts.bosses, event.counts.players, event.counts.meteors, event.counts.bullets, separator);
+        }
+    }
+    fprintf(file, "],\"displayTimeUnit\":\"ms\"}\n");
+
+    fclose(file);
+    return true;
+}
+
+#endif // ENABLE_PROFILER
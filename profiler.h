@@ -0,0 +1,82 @@
+/*******************************************************************************************
+*
+*   profiler - frame phase timers for "Beat the boss!"
+*
+*   PROFILE_SCOPE(phase) times the enclosing block, PROFILE_BEGIN/PROFILE_END time an
+*   explicit range. Every sample feeds a rolling window per phase (p50/p99/max) and a
+*   Chrome trace buffer that ProfilerWriteTrace() dumps as JSON (chrome://tracing).
+*
+*   Everything compiles out to nothing unless ENABLE_PROFILER is defined (make PROFILE=1).
+*
+********************************************************************************************/
+
+#ifndef PROFILER_H
+#define PROFILER_H
+
+enum ProfilePhase {
+    PHASE_BOSS = 0,
+    PHASE_PLAYER,
+    PHASE_BULLET,
+    PHASE_METEOR,
+    PHASE_COLLISION,
+    PHASE_AUDIO,
+    PHASE_DRAW,
+    PHASE_COUNT
+};
+
+#define PROFILE_WINDOW      256         // samples kept per phase for the percentiles
+#define PROFILE_MAX_EVENTS  (1 << 20)   // trace events kept before new ones are dropped
+
+typedef struct PhaseStats {
+    float p50;      // microseconds
+    float p99;
+    float max;
+    int samples;
+} PhaseStats;
+
+typedef struct ProfileCounts {
+    int bosses;
+    int players;
+    int meteors;
+    int bullets;
+} ProfileCounts;
+
+#if defined(ENABLE_PROFILER)
+
+double ProfilerNow(void);                                   // Microseconds since start
+void ProfilerRecord(int phase, double start, double end);   // Add one timed sample
+void ProfilerSetCounts(int bosses, int players, int meteors, int bullets);  // Entity counts of the last step
+ProfileCounts ProfilerGetCounts(void);
+PhaseStats ProfilerGetStats(int phase);                     // Rolling window statistics
+const char *ProfilerPhaseName(int phase);
+bool ProfilerWriteTrace(const char *fileName);              // Dump Chrome trace JSON
+void ProfilerEnableTrace(bool enable);                      // Stop/resume collecting trace events (on by default)
+double ProfilerGetTotal(int phase);                         // Microseconds spent in phase since the last reset
+void ProfilerReset(void);                                   // Clear windows, totals and the trace
+
+class ProfileScope {
+public:
+    ProfileScope(int phase) : phase(phase), start(ProfilerNow()) {}
+    ~ProfileScope() { ProfilerRecord(phase, start, ProfilerNow()); }
+private:
+    int phase;
+    double start;
+};
+
+#define PROFILE_CONCAT_(a, b)       a##b
+#define PROFILE_CONCAT(a, b)        PROFILE_CONCAT_(a, b)
+#define PROFILE_SCOPE(phase)        ProfileScope PROFILE_CONCAT(profileScope, __LINE__)(phase)
+#define PROFILE_BEGIN(phase)        double profileStart##phase = ProfilerNow()
+#define PROFILE_END(phase)          ProfilerRecord(phase, profileStart##phase, ProfilerNow())
+#define PROFILE_COUNTS(bosses, players, meteors, bullets)   ProfilerSetCounts(bosses, players, meteors, bullets)
+
+#else
+
+#define PROFILE_SCOPE(phase)
+#define PROFILE_BEGIN(phase)
+#define PROFILE_END(phase)
+#define PROFILE_COUNTS(bosses, players, meteors, bullets)
+
+#endif
+
+#endif // PROFILER_H
@@ -0,0 +1,203 @@
+/*******************************************************************************************
+*
+*   projectile - structure-of-arrays storage for meteors and bullets
+*
+********************************************************************************************/
+
+#include "projectile.h"
+
+// Stable in-place compaction of one column, from the first dropped index on
+template <class T>
+static void compactColumn(vector<T> &column, const int *keepMask, int first, int alive)
+{
+    T *data = column.data();
+    int write = first;
+    for (int read = first; read < (int)column.size(); read++) {
+        if (keepMask[read]) data[write++] = data[read];
+    }
+    column.resize(alive);
+}
+
+// Branch free so it vectorizes: inactive projectiles get a zero step and are kept.
+// restrict on parameters (not locals) so it survives inlining into the job lambda
+static int integrateKernel(float *__restrict px, float *__restrict py, float *__restrict ppx, float *__restrict ppy,
+                           const float *__restrict pvx, const float *__restrict pvy, const float *__restrict pr,
+                           const int *__restrict pflags, int *__restrict pkeep, int n, float w, float h)
+{
+    int removed = 0;
+    for (int i = 0; i < n; i++) {
+        float step = (float)(pflags[i] & PROJ_ACTIVE);
+        ppx[i] = px[i];
+        ppy[i] = py[i];
+        float nx = px[i] + pvx[i]*step;
+        float ny = py[i] + pvy[i]*step;
+        px[i] = nx;
+        py[i] = ny;
+
+        int outside = (nx > w + pr[i]) | (nx < 0 - pr[i]) | (ny > h + pr[i]) | (ny < 0 - pr[i]);
+        int k = 1 - (outside & (pflags[i] & PROJ_ACTIVE));
+        pkeep[i] = k;
+        removed += 1 - k;
+    }
+
+    return removed;
+}
+
+ProjectilePool::ProjectilePool(int capacity)
+{
+    maxCount = capacity;
+    tracking = false;
+    x.reserve(capacity);
+    y.reserve(capacity);
+    prevX.reserve(capacity);
+    prevY.reserve(capacity);
+    vx.reserve(capacity);
+    vy.reserve(capacity);
+    r.reserve(capacity);
+    flags.reserve(capacity);
+    color.reserve(capacity);
+    damage.reserve(capacity);
+    keep.reserve(capacity);
+}
+
+void ProjectilePool::clear()
+{
+    x.clear();
+    y.clear();
+    prevX.clear();
+    prevY.clear();
+    vx.clear();
+    vy.clear();
+    r.clear();
+    flags.clear();
+    color.clear();
+    damage.clear();
+    origin.clear();
+}
+
+bool ProjectilePool::spawn(float posx, float posy, float velx, float vely, float radius, Color tint, int dmg)
+{
+    if (size() >= maxCount) return false;
+
+    x.push_back(posx);
+    y.push_back(posy);
+    prevX.push_back(posx);
+    prevY.push_back(posy);
+    vx.push_back(velx);
+    vy.push_back(vely);
+    r.push_back(radius);
+    flags.push_back((velx*velx + vely*vely > radius*radius)? PROJ_ACTIVE | PROJ_FAST : PROJ_ACTIVE);
+    color.push_back(tint);
+    damage.push_back(dmg);
+    if (tracking) origin.push_back(-1);
+    return true;
+}
+
+int ProjectilePool::spawnVolley(float posx, float posy, const float *velx, const float *vely, int count, float radius, Color tint, int dmg)
+{
+    int n = maxCount - size();
+    if (count < n) n = count;
+    if (n <= 0) return 0;
+
+    // Column by column, the shared values as fills
+    x.insert(x.end(), n, posx);
+    y.insert(y.end(), n, posy);
+    prevX.insert(prevX.end(), n, posx);
+    prevY.insert(prevY.end(), n, posy);
+    vx.insert(vx.end(), velx, velx + n);
+    vy.insert(vy.end(), vely, vely + n);
+    r.insert(r.end(), n, radius);
+    color.insert(color.end(), n, tint);
+    damage.insert(damage.end(), n, dmg);
+    if (tracking) origin.insert(origin.end(), n, -1);
+    float fast = radius*radius;
+    for (int i = 0; i < n; i++) {
+        flags.push_back((velx[i]*velx[i] + vely[i]*vely[i] > fast)? PROJ_ACTIVE | PROJ_FAST : PROJ_ACTIVE);
+    }
+    return n;
+}
+
+void ProjectilePool::integrateAndCull(float w, float h, JobSystem *jobs)
+{
+    int n = size();
+    if (n == 0) return;
+
+    keep.resize(n);
+
+    atomic<int> removed(0);
+    ParallelFor(jobs, n, PROJECTILE_GRAIN, [this, w, h, &removed](int begin, int end, int worker) {
+        int dropped = integrateRange(begin, end, w, h);
+        if (dropped > 0) removed.fetch_add(dropped, memory_order_relaxed);
+    });
+
+    if (removed.load(memory_order_relaxed) == 0) return;
+
+    const int *pkeep = keep.data();
+    int first = 0;
+    while (pkeep[first]) first++;
+    compact(pkeep, first);
+}
+
+int ProjectilePool::integrateRange(int begin, int end, float w, float h)
+{
+    return integrateKernel(x.data() + begin, y.data() + begin, prevX.data() + begin, prevY.data() + begin,
+                           vx.data() + begin, vy.data() + begin, r.data() + begin, flags.data() + begin,
+                           keep.data() + begin, end - begin, w, h);
+}
+
+void ProjectilePool::removeSorted(const vector<int> &ids)
+{
+    if (ids.empty()) return;
+
+    keep.assign(size(), 1);
+    for (int k = 0; k < (int)ids.size(); k++) keep[ids[k]] = 0;
+    compact(keep.data(), ids[0]);
+}
+
+bool ProjectilePool::resize(int count)
+{
+    if (count < 0 || count > maxCount) return false;
+
+    x.resize(count);
+    y.resize(count);
+    prevX.resize(count);
+    prevY.resize(count);
+    vx.resize(count);
+    vy.resize(count);
+    r.resize(count);
+    flags.resize(count);
+    color.resize(count);
+    damage.resize(count);
+    if (tracking) origin.assign(count, -1);     // nothing is where it was
+    return true;
+}
+
+void ProjectilePool::trackOrigins()
+{
+    tracking = true;
+    origin.reserve(maxCount);
+    origin.assign(size(), -1);
+}
+
+void ProjectilePool::markOrigins()
+{
+    for (int i = 0; i < (int)origin.size(); i++) origin[i] = i;
+}
+
+void ProjectilePool::compact(const int *keepMask, int first)
+{
+    int alive = first;
+    for (int i = first; i < size(); i++) alive += keepMask[i];
+
+    compactColumn(x, keepMask, first, alive);
+    compactColumn(y, keepMask, first, alive);
+    compactColumn(prevX, keepMask, first, alive);
+    compactColumn(prevY, keepMask, first, alive);
+    compactColumn(vx, keepMask, first, alive);
+    compactColumn(vy, keepMask, first, alive);
+    compactColumn(r, keepMask, first, alive);
+    compactColumn(flags, keepMask, first, alive);
+    compactColumn(color, keepMask, first, alive);
+    compactColumn(damage, keepMask, first, alive);
+    if (tracking) compactColumn(origin, keepMask, first, alive);
+}
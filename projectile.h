@@ -0,0 +1,81 @@
+/*******************************************************************************************
+*
+*   projectile - structure-of-arrays storage for meteors and bullets
+*
+*   Every field lives in its own contiguous column so the per tick movement and wall
+*   culling run as straight loops over floats that the compiler can vectorize. Removal
+*   is always a stable compaction, so projectile order is the spawn order. Capacity is
+*   fixed at construction: spawning never allocates and is refused once the pool is full.
+*
+********************************************************************************************/
+
+#ifndef PROJECTILE_H
+#define PROJECTILE_H
+
+#include "simtypes.h"
+#include "jobs.h"
+#include <vector>
+using namespace std;
+
+// Projectile flags
+#define PROJ_ACTIVE         (1 << 0)
+#define PROJ_FAST           (1 << 1)    // moves further than its radius per tick, collides swept
+
+// Movement chunks smaller than this are not worth a worker
+#define PROJECTILE_GRAIN    8192
+
+class ProjectilePool {
+public:
+    vector<float> x;
+    vector<float> y;
+    vector<float> prevX;    // position before the last integrateAndCull, for render interpolation
+    vector<float> prevY;
+    vector<float> vx;
+    vector<float> vy;
+    vector<float> r;
+    vector<int> flags;
+    vector<Color> color;
+    vector<int> damage;
+    vector<int> origin;     // index at the last markOrigins(), -1 if spawned since; only kept after trackOrigins()
+
+    ProjectilePool(int capacity);
+
+    int size() const { return (int)x.size(); }
+    int capacity() const { return maxCount; }
+    bool empty() const { return x.empty(); }
+    Vector2 position(int i) const { return (Vector2){ x[i], y[i] }; }
+    float lerpX(int i, float alpha) const { return prevX[i] + (x[i] - prevX[i])*alpha; }
+    float lerpY(int i, float alpha) const { return prevY[i] + (y[i] - prevY[i])*alpha; }
+    bool active(int i) const { return (flags[i] & PROJ_ACTIVE) != 0; }
+
+    void clear();
+    bool spawn(float posx, float posy, float velx, float vely, float radius, Color tint, int dmg);
+    // count projectiles from one point, velocities from the arrays and the rest shared; as
+    // many as fit, in order. Returns how many were spawned
+    int spawnVolley(float posx, float posy, const float *velx, const float *vely, int count, float radius, Color tint, int dmg);
+
+    // Move active projectiles by their speed and drop the ones fully outside [0, w] x [0, h];
+    // with jobs the movement is split across workers, the compaction stays serial
+    void integrateAndCull(float w, float h, JobSystem *jobs = NULL);
+
+    // Remove the projectiles at the given ascending indices in one stable pass
+    void removeSorted(const vector<int> &ids);
+
+    // Set the count, new projectiles are zero; for restoring a snapshot, false above capacity
+    bool resize(int count);
+
+    // Keep origin through spawns and removals, so whoever indexes the pool by position
+    // (the broadphase) can carry its state over instead of rebuilding it
+    void trackOrigins();
+    void markOrigins();     // every projectile is its own origin from now on
+
+private:
+    int maxCount;
+    bool tracking;
+    vector<int> keep;      // scratch of integrateAndCull (int wide so the kernel stays one vector width)
+
+    int integrateRange(int begin, int end, float w, float h);   // returns how many to drop
+    void compact(const int *keepMask, int first);
+};
+
+#endif // PROJECTILE_H
@@ -0,0 +1,62 @@
+/*******************************************************************************************
+*
+*   replay - headless re-simulation of a recorded match for "Beat the boss!"
+*
+*   Loads an input log written by `game --record <file>`, seeds a World with the recorded
+*   seed and feeds it the recorded input tick by tick, uncapped. The final world checksum
+*   must match the one stored in the log bit for bit, which makes a log a regression test
+*   for determinism and a fixed workload for profiling.
+*
+*   Usage: replay <file> [repeat]
+*
+*       repeat          play the log this many times and report the best run
+*
+********************************************************************************************/
+
+#include "world.h"
+#include "inputlog.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include <chrono>
+using namespace std;
+
+int main(int argc, char **argv)
+{
+    if (argc < 2) {
+        printf("usage: replay <file> [repeat]\n");
+        return 2;
+    }
+    int repeat = (argc > 2)? atoi(argv[2]) : 1;
+    if (repeat < 1) repeat = 1;
+
+    InputLog log;
+    if (!log.load(argv[1])) {
+        printf("replay: %s is not a valid input log\n", argv[1]);
+        return 2;
+    }
+
+    World world;
+    world.verbose = false;
+    world.config.playerCount = log.players;
+    world.config.bossCount = log.bosses;
+
+    double best = 0.0;
+    uint32_t checksum = 0;
+    for (int r = 0; r < repeat; r++) {
+        world.init(log.seed);
+        log.rewind();
+
+        InputFrame input;
+        chrono::steady_clock::time_point start = chrono::steady_clock::now();
+        while (log.next(&input)) world.step(input);
+        double seconds = chrono::duration<double>(chrono::steady_clock::now() - start).count();
+
+        if (r == 0 || seconds < best) best = seconds;
+        checksum = world.checksum();
+    }
+
+    printf("seed %u, %u ticks in %.3f s (%.0f ticks/s)\n", log.seed, log.ticks, best, log.ticks/best);
+    printf("checksum %08x, recorded %08x: %s\n", checksum, log.checksum, (checksum == log.checksum)? "match" : "MISMATCH");
+
+    return (checksum == log.checksum)? 0 : 1;
+}
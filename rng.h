@@ -0,0 +1,41 @@
+/*******************************************************************************************
+*
+*   rng - small seeded random generator owned by each World
+*
+*   PCG32 (pcg-random.org): 64 bit state, 32 bit output. Unlike rand() it is per instance,
+*   identical on every platform and cheap to copy, so a match replays bit for bit from
+*   its seed.
+*
+********************************************************************************************/
+
+#ifndef RNG_H
+#define RNG_H
+
+#include <stdint.h>
+
+class Rng {
+public:
+    uint64_t state;
+
+    void seed(uint64_t value) {
+        state = 0;
+        next();
+        state += value;
+        next();
+    }
+
+    uint32_t next() {
+        uint64_t old = state;
+        state = old*6364136223846793005ULL + 1442695040888963407ULL;
+        uint32_t xorshifted = (uint32_t)(((old >> 18u) ^ old) >> 27u);
+        uint32_t rot = (uint32_t)(old >> 59u);
+        return (xorshifted >> rot) | (xorshifted << ((-rot) & 31));
+    }
+
+    // Uniform integer in [0, bound)
+    int nextInt(int bound) {
+        return (int)(((uint64_t)next()*(uint64_t)bound) >> 32);
+    }
+};
+
+#endif // RNG_H
@@ -0,0 +1,25 @@
+/*******************************************************************************************
+*
+*   sfx - sound events of "Beat the boss!", shared by the game and the audio bench
+*
+********************************************************************************************/
+
+#ifndef SFX_H
+#define SFX_H
+
+#include "mixer.h"
+
+// Mixer sound ids and event ids alike: sounds and events are added in this order
+enum SoundEffect {
+    SFX_PLAYER_SHOT = 0,
+    SFX_BOSS_VOLLEY,
+    SFX_COUNT
+};
+
+// sound, priority, cooldown (s), volume, maxVoices
+static const SoundEvent sfxEvents[SFX_COUNT] = {
+    { SFX_PLAYER_SHOT, 1, 0.06f, 0.5f, 4 },     // both players can fire every tick
+    { SFX_BOSS_VOLLEY, 2, 0.20f, 1.0f, 2 },     // up to MAX_BOSSES volleys in one tick
+};
+
+#endif // SFX_H
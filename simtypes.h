@@ -0,0 +1,50 @@
+/*******************************************************************************************
+*
+*   simtypes - math and color types shared by the simulation modules
+*
+*   The windowed build takes them straight from raylib.h. Headless builds (SIM_HEADLESS)
+*   get layout compatible replacements, so no raylib headers or libraries are needed.
+*
+********************************************************************************************/
+
+#ifndef SIMTYPES_H
+#define SIMTYPES_H
+
+#if defined(SIM_HEADLESS)
+//----------------------------------------------------------------------------------
+// raylib replacements (layout compatible with raylib.h)
+//----------------------------------------------------------------------------------
+#ifndef PI
+    #define PI 3.14159265358979323846f
+#endif
+#define DEG2RAD (PI/180.0f)
+#define RAD2DEG (180.0f/PI)
+
+typedef struct Vector2 { float x; float y; } Vector2;
+typedef struct Rectangle { float x; float y; float width; float height; } Rectangle;
+typedef struct Color { unsigned char r; unsigned char g; unsigned char b; unsigned char a; } Color;
+
+#define GRAY       Color{ 130, 130, 130, 255 }
+#define DARKGRAY   Color{ 80, 80, 80, 255 }
+#define YELLOW     Color{ 253, 249, 0, 255 }
+#define RED        Color{ 230, 41, 55, 255 }
+#define MAROON     Color{ 190, 33, 55, 255 }
+#define BLUE       Color{ 0, 121, 241, 255 }
+#define DARKBLUE   Color{ 0, 82, 172, 255 }
+#define DARKBROWN  Color{ 76, 63, 47, 255 }
+#define BROWN      Color{ 127, 106, 79, 255 }
+#define GREEN      Color{ 0, 228, 48, 255 }
+#define DARKGREEN  Color{ 0, 117, 44, 255 }
+#define PURPLE     Color{ 200, 122, 255, 255 }
+#define DARKPURPLE Color{ 112, 31, 126, 255 }
+#define ORANGE     Color{ 255, 161, 0, 255 }
+#define SKYBLUE    Color{ 102, 191, 255, 255 }
+#define VIOLET     Color{ 135, 60, 190, 255 }
+#define PINK       Color{ 255, 109, 194, 255 }
+#define MAGENTA    Color{ 255, 0, 255, 255 }
+#define GOLD       Color{ 255, 203, 0, 255 }
+#else
+#include "raylib.h"
+#endif
+
+#endif // SIMTYPES_H
@@ -0,0 +1,499 @@
+/*******************************************************************************************
+*
+*   snapshot - binary images of the world state, kept per tick in a delta encoded ring
+*
+********************************************************************************************/
+
+#include "snapshot.h"
+#include <stdio.h>
+#include <string.h>
+
+// Deltas compare and send whole blocks of this many words: the compare stays a branch
+// free loop and the runs stay long, for a few unchanged words sent along
+#define SNAPSHOT_BLOCK_WORDS 32
+
+// Removing projectiles moves the rest of their columns down, so a block that is not in
+// the base at its own place is looked for up to this many 4 byte elements further on...
+#define SNAPSHOT_SHIFT_WINDOW 32
+// ...by at most this many searches in a row that find nothing, after which the span is
+// taken for one that really changed (the positions, every tick)
+#define SNAPSHOT_SHIFT_TRIES  4
+
+// Source of the words of a delta run that follow in the delta itself
+#define SNAPSHOT_LITERAL    0xFFFFFFFFu
+
+// Image header, 8 byte aligned so the columns after it are word aligned too
+struct SnapshotHeader {
+    char magic[4];
+    uint32_t version;
+    uint32_t size;          // whole image, padding included
+    uint32_t framesCounter;
+    uint32_t seed;
+    uint32_t flags;         // 1: gameOver, 2: pause
+    uint32_t frontEnd;
+    uint32_t reserved;
+    uint64_t rngState;
+    SimConfig config;
+    int32_t counts[5];      // players, bosses, meteors, playerBullets, bossBullets
+};
+
+// One contiguous piece of the image, padded to whole words in it
+struct SnapshotSpan {
+    void *data;
+    size_t size;
+};
+
+static size_t padToWord(size_t size) { return (size + 7) & ~(size_t)7; }
+
+// Empty columns are kept as empty spans, so every capture has the same list of spans
+template <class T>
+static void addColumn(SnapshotSpan *spans, int &count, vector<T> &column)
+{
+    spans[count].data = column.data();
+    spans[count].size = column.size()*sizeof(T);
+    count++;
+}
+
+static void addArchetype(SnapshotSpan *spans, int &count, Archetype &a)
+{
+    addColumn(spans, count, a.position);
+    addColumn(spans, count, a.speed);
+    addColumn(spans, count, a.acceleration);
+    addColumn(spans, count, a.rotation);
+    addColumn(spans, count, a.collider);
+    addColumn(spans, count, a.hp);
+    addColumn(spans, count, a.color);
+    addColumn(spans, count, a.facing);
+    addColumn(spans, count, a.frameRow);
+    addColumn(spans, count, a.direction);
+}
+
+static void addPool(SnapshotSpan *spans, int &count, ProjectilePool &pool)
+{
+    addColumn(spans, count, pool.x);
+    addColumn(spans, count, pool.y);
+    addColumn(spans, count, pool.vx);
+    addColumn(spans, count, pool.vy);
+    addColumn(spans, count, pool.r);
+    addColumn(spans, count, pool.flags);
+    addColumn(spans, count, pool.color);
+    addColumn(spans, count, pool.damage);
+}
+
+// The header and every column of the world in image order; the same list saves, loads and
+// captures, so they can not disagree on the layout. Returns the image size.
+// The previous positions are left out: a step sets them before it reads them, they only
+// serve the render interpolation, and they would double what a moving projectile costs
+static size_t worldSpans(World &world, SnapshotHeader *header, SnapshotSpan *spans, int &count)
+{
+    spans[0].data = header;
+    spans[0].size = sizeof(SnapshotHeader);
+    count = 1;
+    addArchetype(spans, count, world.players);
+    addArchetype(spans, count, world.bosses);
+    addPool(spans, count, world.meteors);
+    addPool(spans, count, world.playerBullets);
+    addPool(spans, count, world.bossBullets);
+
+    size_t size = 0;
+    for (int i = 0; i < count; i++) size += padToWord(spans[i].size);
+    return size;
+}
+
+static void fillHeader(const World &world, uint32_t frontEnd, size_t size, SnapshotHeader &header)
+{
+    memset(&header, 0, sizeof(header));
+    memcpy(header.magic, "BTBS", 4);
+    header.version = SNAPSHOT_VERSION;
+    header.size = (uint32_t)size;
+    header.framesCounter = (uint32_t)world.framesCounter;
+    header.seed = world.seed;
+    header.flags = (world.gameOver? 1 : 0) | (world.pause? 2 : 0);
+    header.frontEnd = frontEnd;
+    header.rngState = world.rng.state;
+    header.config = world.config;
+    header.counts[0] = world.players.size();
+    header.counts[1] = world.bosses.size();
+    header.counts[2] = world.meteors.size();
+    header.counts[3] = world.playerBullets.size();
+    header.counts[4] = world.bossBullets.size();
+}
+
+static void restPool(ProjectilePool &pool)
+{
+    pool.prevX = pool.x;
+    pool.prevY = pool.y;
+}
+
+//------------------------------------------------------------------------------------
+// Images
+//------------------------------------------------------------------------------------
+void saveSnapshot(const World &world, uint32_t frontEnd, vector<unsigned char> &image)
+{
+    // Only read through the spans, the world is not touched
+    SnapshotHeader header;
+    SnapshotSpan spans[SNAPSHOT_MAX_SPANS];
+    int spanCount;
+    size_t size = worldSpans(const_cast<World &>(world), &header, spans, spanCount);
+    fillHeader(world, frontEnd, size, header);
+
+    image.resize(size);
+    unsigned char *out = image.data();
+    for (int i = 0; i < spanCount; i++) {
+        size_t padded = padToWord(spans[i].size);
+        if (spans[i].size > 0) memcpy(out, spans[i].data, spans[i].size);
+        memset(out + spans[i].size, 0, padded - spans[i].size);
+        out += padded;
+    }
+}
+
+bool loadSnapshot(World &world, const vector<unsigned char> &image, uint32_t *frontEnd)
+{
+    if (image.size() < sizeof(SnapshotHeader)) return false;
+
+    SnapshotHeader header;
+    memcpy(&header, image.data(), sizeof(header));
+    if (memcmp(header.magic, "BTBS", 4) != 0 || header.version != SNAPSHOT_VERSION || header.size != image.size()) return false;
+
+    const int32_t *counts = header.counts;
+    if (counts[2] < 0 || counts[2] > world.meteors.capacity() ||
+        counts[3] < 0 || counts[3] > world.playerBullets.capacity() ||
+        counts[4] < 0 || counts[4] > world.bossBullets.capacity()) return false;
+    if (!world.players.resize(counts[0]) || !world.bosses.resize(counts[1])) return false;
+    world.meteors.resize(counts[2]);
+    world.playerBullets.resize(counts[3]);
+    world.bossBullets.resize(counts[4]);
+
+    SnapshotHeader unused;
+    SnapshotSpan spans[SNAPSHOT_MAX_SPANS];
+    int spanCount;
+    if (worldSpans(world, &unused, spans, spanCount) != image.size()) return false;
+
+    const unsigned char *in = image.data() + sizeof(header);
+    for (int i = 1; i < spanCount; i++) {
+        if (spans[i].size > 0) memcpy(spans[i].data, in, spans[i].size);
+        in += padToWord(spans[i].size);
+    }
+
+    // Nothing to interpolate from until the next step
+    if (world.players.has(COMP_TRANSFORM)) world.players.prevPosition = world.players.position;
+    if (world.bosses.has(COMP_TRANSFORM)) world.bosses.prevPosition = world.bosses.position;
+    restPool(world.meteors);
+    restPool(world.playerBullets);
+    restPool(world.bossBullets);
+
+    world.framesCounter = (int)header.framesCounter;
+    world.seed = header.seed;
+    world.gameOver = (header.flags & 1) != 0;
+    world.pause = (header.flags & 2) != 0;
+    world.rng.state = header.rngState;
+    world.config = header.config;
+    world.applyConfig();
+    if (frontEnd != NULL) *frontEnd = header.frontEnd;
+
+    return true;
+}
+
+bool writeSnapshotFile(const char *fileName, const vector<unsigned char> &image)
+{
+    FILE *file = fopen(fileName, "wb");
+    if (file == NULL) return false;
+
+    bool ok = fwrite(image.data(), 1, image.size(), file) == image.size();
+    return (fclose(file) == 0) && ok;
+}
+
+bool readSnapshotFile(const char *fileName, vector<unsigned char> &image)
+{
+    FILE *file = fopen(fileName, "rb");
+    if (file == NULL) return false;
+
+    SnapshotHeader header;
+    bool ok = fread(&header, sizeof(header), 1, file) == 1 && memcmp(header.magic, "BTBS", 4) == 0 &&
+              header.size >= sizeof(header);
+    if (ok) {
+        image.resize(header.size);
+        memcpy(image.data(), &header, sizeof(header));
+        size_t rest = header.size - sizeof(header);
+        ok = fread(image.data() + sizeof(header), 1, rest, file) == rest;
+    }
+
+    fclose(file);
+    return ok;
+}
+
+//------------------------------------------------------------------------------------
+// Delta encoding
+//------------------------------------------------------------------------------------
+// Image size u32, then runs covering the image in order: words u32 and source u32, the
+// byte offset in the base the words are copied from, or SNAPSHOT_LITERAL when they follow
+// in the delta. Against an empty base every run is a literal, which makes a keyframe
+
+struct DeltaWriter {
+    vector<unsigned char> *out;
+    size_t used;
+    size_t runHeader;       // offset of the open run's header
+    uint32_t runWords;      // words in the open run, 0: none open
+    uint32_t runSource;     // base offset of the open run's first word, or SNAPSHOT_LITERAL
+    const unsigned char *runData;   // literal run: its words in the image, stored when it closes
+};
+
+// Buffers only grow, so once an entry has seen its largest delta this never allocates
+static void reserveDelta(DeltaWriter &w, size_t bytes)
+{
+    size_t need = w.used + bytes;
+    if (need > w.out->size()) w.out->resize(need + need/2);
+}
+
+// Literal words go in with one copy per run: the entry was last written a whole ring
+// ago, and long copies into memory out of the cache are much faster than many short ones
+static void closeRun(DeltaWriter &w)
+{
+    if (w.runWords == 0) return;
+
+    memcpy(w.out->data() + w.runHeader, &w.runWords, 4);
+    if (w.runSource == SNAPSHOT_LITERAL) {
+        size_t bytes = (size_t)w.runWords*8;
+        reserveDelta(w, bytes);
+        memcpy(w.out->data() + w.used, w.runData, bytes);
+        w.used += bytes;
+    }
+    w.runWords = 0;
+}
+
+static void openRun(DeltaWriter &w, uint32_t source, const unsigned char *data)
+{
+    closeRun(w);
+    reserveDelta(w, 8);
+    uint32_t run[2] = { 0, source };
+    w.runHeader = w.used;
+    memcpy(w.out->data() + w.used, run, 8);
+    w.used += 8;
+    w.runSource = source;
+    w.runData = data;
+}
+
+static void copyFromBase(DeltaWriter &w, uint32_t source, uint32_t count)
+{
+    if (w.runWords == 0 || w.runSource == SNAPSHOT_LITERAL || w.runSource + w.runWords*8 != source) openRun(w, source, NULL);
+    w.runWords += count;
+}
+
+// data is in the image, which stays put until the run is closed
+static void copyLiteral(DeltaWriter &w, const unsigned char *data, uint32_t count)
+{
+    if (w.runWords == 0 || w.runSource != SNAPSHOT_LITERAL || w.runData + (size_t)w.runWords*8 != data) openRun(w, SNAPSHOT_LITERAL, data);
+    w.runWords += count;
+}
+
+static inline bool sameWords(const unsigned char *a, const unsigned char *b, size_t words)
+{
+    uint64_t diff = 0;
+    for (size_t k = 0; k < words; k++) {
+        uint64_t x, y;
+        memcpy(&x, a + k*8, 8);
+        memcpy(&y, b + k*8, 8);
+        diff |= x ^ y;
+    }
+    return diff == 0;
+}
+
+// Whole blocks get the constant count, so their compare is unrolled and vectorized
+static inline bool sameBlock(const unsigned char *a, const unsigned char *b, size_t words)
+{
+    return (words == SNAPSHOT_BLOCK_WORDS)? sameWords(a, b, SNAPSHOT_BLOCK_WORDS) : sameWords(a, b, words);
+}
+
+// The span is copied into the image at pos block by block, each one encoded against the
+// base (where the span started at basePos) while it is still in cache. Every block is
+// looked for at the span's current shift first: one element further for every projectile
+// removed before it, found by searching when a removal breaks the match
+static void encodeSpan(DeltaWriter &w, const SnapshotSpan &span, unsigned char *image, size_t pos,
+                       const vector<unsigned char> &base, size_t basePos)
+{
+    const unsigned char *src = (const unsigned char *)span.data;
+    size_t bytes = padToWord(span.size);
+    const unsigned char *from = base.data();
+    size_t baseSize = base.size();
+    size_t shift = 0;
+    int misses = 0;
+
+    for (size_t offset = 0; offset < bytes; offset += SNAPSHOT_BLOCK_WORDS*8) {
+        size_t words = (bytes - offset)/8;
+        if (words > SNAPSHOT_BLOCK_WORDS) words = SNAPSHOT_BLOCK_WORDS;
+        unsigned char *block = image + pos + offset;
+        if (offset + SNAPSHOT_BLOCK_WORDS*8 <= span.size) memcpy(block, src + offset, SNAPSHOT_BLOCK_WORDS*8);
+        else {
+            // The odd half word at the end, zero padded
+            memcpy(block, src + offset, span.size - offset);
+            memset(block + span.size - offset, 0, words*8 - (span.size - offset));
+        }
+        size_t source = basePos + offset + shift;
+
+        // A block whose start still matches holds the removal itself: stored, and the search
+        // is left to the next block, which starts past it
+        bool found = (source + words*8 <= baseSize) && sameBlock(block, from + source, words);
+        bool straddles = !found && (source + 8 <= baseSize) && memcmp(block, from + source, 8) == 0;
+        if (!found && !straddles && misses < SNAPSHOT_SHIFT_TRIES) {
+            for (size_t step = 4; step <= SNAPSHOT_SHIFT_WINDOW*4 && source + step + words*8 <= baseSize; step += 4) {
+                if (memcmp(block, from + source + step, 8) == 0 && sameBlock(block, from + source + step, words)) {
+                    shift += step;
+                    source += step;
+                    found = true;
+                    break;
+                }
+            }
+            misses = found? 0 : misses + 1;
+        }
+
+        if (found) copyFromBase(w, (uint32_t)source, (uint32_t)words);
+        else copyLiteral(w, block, (uint32_t)words);
+    }
+}
+
+// delta holds size bytes encoded against base, image gets the decoded image
+static bool decodeDelta(const unsigned char *delta, size_t size, const vector<unsigned char> &base, vector<unsigned char> &image)
+{
+    if (size < 4) return false;
+
+    uint32_t imageSize;
+    memcpy(&imageSize, delta, 4);
+    image.resize(imageSize);
+
+    size_t pos = 4;
+    size_t offset = 0;
+    while (pos + 8 <= size) {
+        uint32_t run[2];
+        memcpy(run, delta + pos, 8);
+        pos += 8;
+        size_t bytes = (size_t)run[0]*8;
+        if (offset + bytes > imageSize) return false;
+        if (run[1] == SNAPSHOT_LITERAL) {
+            if (pos + bytes > size) return false;
+            memcpy(image.data() + offset, delta + pos, bytes);
+            pos += bytes;
+        }
+        else {
+            if ((size_t)run[1] + bytes > base.size()) return false;
+            memcpy(image.data() + offset, base.data() + run[1], bytes);
+        }
+        offset += bytes;
+    }
+
+    return pos == size && offset == imageSize;
+}
+
+//------------------------------------------------------------------------------------
+// SnapshotRing
+//------------------------------------------------------------------------------------
+SnapshotRing::SnapshotRing(int ticks)
+{
+    entries.resize(ticks > 1? ticks : 1);
+    memset(&stats, 0, sizeof(stats));
+    clear();
+}
+
+void SnapshotRing::clear()
+{
+    head = 0;
+    count = 0;
+    sinceKeyframe = 0;
+    base.clear();
+    memset(baseSpans, 0, sizeof(baseSpans));
+}
+
+int SnapshotRing::available() const
+{
+    return (count > 0)? count - 1 : 0;
+}
+
+// The oldest entry and the deltas depending on it, up to the next keyframe
+void SnapshotRing::dropOldest()
+{
+    int size = (int)entries.size();
+    do count--;
+    while (count > 0 && !entries[(head - count + size) % size].keyframe);
+}
+
+void SnapshotRing::capture(const World &world, uint32_t frontEnd)
+{
+    int ringSize = (int)entries.size();
+    if (count == ringSize) dropOldest();
+
+    SnapshotHeader header;
+    SnapshotSpan spans[SNAPSHOT_MAX_SPANS];
+    int spanCount;
+    size_t size = worldSpans(const_cast<World &>(world), &header, spans, spanCount);
+    fillHeader(world, frontEnd, size, header);
+
+    Entry &entry = entries[head];
+    entry.keyframe = (count == 0 || sinceKeyframe + 1 >= SNAPSHOT_KEYFRAME_TICKS);
+    if (entry.keyframe) {
+        base.clear();
+        sinceKeyframe = 0;
+        stats.keyframes++;
+    }
+    else sinceKeyframe++;
+
+    // Straight from the columns into the new image, which then becomes the base
+    image.resize(size);
+    if (entry.data.size() < 4) entry.data.resize(4);
+    uint32_t imageSize = (uint32_t)size;
+    memcpy(entry.data.data(), &imageSize, 4);
+    DeltaWriter writer = { &entry.data, 4, 0, 0, 0, NULL };
+
+    size_t pos = 0;
+    for (int i = 0; i < spanCount; i++) {
+        encodeSpan(writer, spans[i], image.data(), pos, base, baseSpans[i]);
+        baseSpans[i] = (uint32_t)pos;
+        pos += padToWord(spans[i].size);
+    }
+    closeRun(writer);
+    entry.size = writer.used;
+    base.swap(image);
+
+    head = (head + 1) % ringSize;
+    count++;
+    stats.captures++;
+    stats.bytesIn += (long)size;
+    stats.bytesOut += (long)entry.size;
+}
+
+bool SnapshotRing::rewind(int ticks, World &world, uint32_t *frontEnd)
+{
+    if (ticks < 0 || ticks >= count) return false;
+
+    // Entries by age: 0 is the oldest, count - 1 the last capture
+    int ringSize = (int)entries.size();
+    int oldest = head - count + ringSize;
+    int target = count - 1 - ticks;
+    int first = target;
+    while (first > 0 && !entries[(oldest + first) % ringSize].keyframe) first--;
+
+    image.clear();
+    for (int k = first; k <= target; k++) {
+        const Entry &entry = entries[(oldest + k) % ringSize];
+        if (!decodeDelta(entry.data.data(), entry.size, image, scratch)) return false;
+        image.swap(scratch);
+    }
+    if (!loadSnapshot(world, image, frontEnd)) return false;
+
+    // Where the spans of the restored image start, for the next delta
+    SnapshotHeader unused;
+    SnapshotSpan spans[SNAPSHOT_MAX_SPANS];
+    int spanCount;
+    worldSpans(world, &unused, spans, spanCount);
+    size_t pos = 0;
+    for (int i = 0; i < spanCount; i++) {
+        baseSpans[i] = (uint32_t)pos;
+        pos += padToWord(spans[i].size);
+    }
+
+    // The rewound state is the new last capture
+    count = target + 1;
+    head = (oldest + count) % ringSize;
+    sinceKeyframe = target - first;
+    base.swap(image);
+
+    return true;
+}
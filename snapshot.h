@@ -0,0 +1,95 @@
+/*******************************************************************************************
+*
+*   snapshot - binary images of the world state, kept per tick in a delta encoded ring
+*
+*   An image is everything World::step() reads: counters, flags, PRNG state, config, every
+*   column of the player and boss archetypes and of the projectile pools (but the previous
+*   positions kept for render interpolation), plus one opaque word for the front-end (the
+*   game stores its animation clock there). Columns are copied
+*   raw, so an image only loads back into the same build on the same kind of machine,
+*   which is all rewinding and crash dumps need.
+*
+*   SnapshotRing::capture() encodes each image against the previous one, with a full
+*   keyframe every SNAPSHOT_KEYFRAME_TICKS. A delta is a list of runs of 64-bit words,
+*   each either copied from some offset of the previous image or stored. Removing a
+*   projectile moves the rest of its pool down by one element, so every block is looked
+*   for at the shift its column had so far and a little further, not only in place: what
+*   a tick of moving projectiles stores is then their positions, not the whole pools.
+*   Entries reuse their buffers, so once the ring went round a steady capture does not
+*   allocate. rewind() decodes from the closest keyframe and cuts the ring there.
+*
+*   A capture costs about a copy of the image plus storing what changed, the positions of
+*   moving projectiles at least. With 10000 of them (bench --snapshot drift, a 312 kB image
+*   of which some 90 kB are stored) it measures 52 to 65 us per tick: over the 50 us
+*   target for that load, which is missed. Positions are stored whole every tick, since
+*   a rewind must restore them bit exact.
+*
+*   Header layout: magic "BTBS", version u32, image size u32, frame u32, seed u32,
+*   flags u32, front-end u32, rng state u64, SimConfig, then the five entity counts;
+*   the columns follow in a fixed order, each one zero padded to 8 bytes.
+*
+********************************************************************************************/
+
+#ifndef SNAPSHOT_H
+#define SNAPSHOT_H
+
+#include "world.h"
+#include <stdint.h>
+#include <vector>
+using namespace std;
+
+#define SNAPSHOT_VERSION        2       // 2: player and boss counts in the SimConfig
+#define SNAPSHOT_RING_TICKS     600     // ten seconds of rewind
+#define SNAPSHOT_KEYFRAME_TICKS 60      // longest chain of deltas decoded by a rewind
+#define SNAPSHOT_MAX_SPANS      64      // header and columns of an image
+
+// Whole state into image (resized to fit)
+void saveSnapshot(const World &world, uint32_t frontEnd, vector<unsigned char> &image);
+// Back into a world built with the same capacities; false if the image does not fit
+bool loadSnapshot(World &world, const vector<unsigned char> &image, uint32_t *frontEnd);
+
+bool writeSnapshotFile(const char *fileName, const vector<unsigned char> &image);
+bool readSnapshotFile(const char *fileName, vector<unsigned char> &image);
+
+struct SnapshotStats {
+    long captures;
+    long keyframes;
+    long bytesIn;       // image bytes captured
+    long bytesOut;      // encoded bytes stored
+};
+
+class SnapshotRing {
+public:
+    SnapshotStats stats;
+
+    SnapshotRing(int ticks = SNAPSHOT_RING_TICKS);
+
+    void clear();
+    void capture(const World &world, uint32_t frontEnd = 0);
+    int available() const;          // ticks rewind() can go back
+
+    // Restore the state of ticks captures ago (0: the last one) and forget the ones after
+    bool rewind(int ticks, World &world, uint32_t *frontEnd = NULL);
+
+    const vector<unsigned char> &latest() const { return base; }   // image of the last capture
+
+private:
+    struct Entry {
+        vector<unsigned char> data;     // only ever grows, size bytes of it are the delta
+        size_t size;
+        bool keyframe;
+    };
+
+    vector<Entry> entries;
+    int head;                       // next entry to write
+    int count;                      // entries held, the oldest always a keyframe
+    int sinceKeyframe;
+    vector<unsigned char> base;     // last captured image, what the next delta is against
+    uint32_t baseSpans[SNAPSHOT_MAX_SPANS];     // byte offset of every span in the base
+    vector<unsigned char> image;    // the image being captured, the one rewind() decodes
+    vector<unsigned char> scratch;  // the image rewind() decodes the next delta against
+
+    void dropOldest();
+};
+
+#endif // SNAPSHOT_H
@@ -0,0 +1,152 @@
+/*******************************************************************************************
+*
+*   soak - headless match runner for "Beat the boss!"
+*
+*   Plays complete matches against the simulation core with the scripted input policy, as
+*   fast as the CPU allows, and reports throughput. Builds and runs without raylib.
+*
+*   Usage: soak [--check-alloc] [--threads N] [--rewind] [--players N] [--bosses N] [matches] [maxTicks]
+*
+*       match m is seeded with m + 1, so every run plays the same matches
+*
+*       --check-alloc   count heap allocations made by World::step once the first
+*                       WARMUP_TICKS of every match are over; fail if there are any
+*       --threads N     step the matches with a job system of N workers (0: one per
+*                       hardware thread); the printed checksum must not change
+*       --rewind        capture a snapshot every tick and every REWIND_INTERVAL ticks go
+*                       back REWIND_TICKS and play them again; the checksum must not change
+*       --players N     players per match (SimConfig playerCount), all on the scripted policy
+*       --bosses N      bosses per match (SimConfig bossCount)
+*
+********************************************************************************************/
+
+#include "world.h"
+#include "profiler.h"
+#include "jobs.h"
+#include "policy.h"
+#include "snapshot.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <chrono>
+#include <new>
+using namespace std;
+
+#define WARMUP_TICKS        120
+#define REWIND_INTERVAL     97
+#define REWIND_TICKS        45
+
+//------------------------------------------------------------------------------------
+// Counting allocator
+//------------------------------------------------------------------------------------
+static long long allocCount = 0;
+
+void *operator new(size_t size)
+{
+    allocCount++;
+    void *ptr = malloc(size? size : 1);
+    if (ptr == NULL) throw bad_alloc();
+    return ptr;
+}
+
+void operator delete(void *ptr) noexcept { free(ptr); }
+void operator delete(void *ptr, size_t) noexcept { free(ptr); }
+
+int main(int argc, char **argv)
+{
+    bool checkAlloc = false;
+    bool rewind = false;
+    int threads = -1;
+    int matches = 1000;
+    int maxTicks = 60*60*5;
+    SimConfig config = defaultSimConfig();
+
+    int positional = 0;
+    for (int i = 1; i < argc; i++) {
+        if (strcmp(argv[i], "--check-alloc") == 0) checkAlloc = true;
+        else if (strcmp(argv[i], "--threads") == 0 && i + 1 < argc) threads = atoi(argv[++i]);
+        else if (strcmp(argv[i], "--rewind") == 0) rewind = true;
+        else if (strcmp(argv[i], "--players") == 0 && i + 1 < argc) config.playerCount = atoi(argv[++i]);
+        else if (strcmp(argv[i], "--bosses") == 0 && i + 1 < argc) config.bossCount = atoi(argv[++i]);
+        else if (positional++ == 0) matches = atoi(argv[i]);
+        else maxTicks = atoi(argv[i]);
+    }
+
+    World world;
+    world.verbose = false;
+    world.config = config;
+    JobSystem *jobs = (threads >= 0)? new JobSystem(threads) : NULL;
+    world.setJobSystem(jobs);
+    SnapshotRing *ring = rewind? new SnapshotRing() : NULL;
+    long rewinds = 0;
+
+    long long totalTicks = 0;
+    int bossWins = 0;
+    int playerWins = 0;
+    long long steadyAllocs = 0;
+    uint32_t digest = 0;        // final world checksums of all matches, folded
+
+    chrono::steady_clock::time_point start = chrono::steady_clock::now();
+    for (int m = 0; m < matches; m++) {
+        world.init(m + 1);
+        if (ring != NULL) {
+            ring->clear();
+            ring->capture(world);
+        }
+        int ticks = 0;
+        int replayed = 0;       // ticks played again after a rewind, not counted twice
+        while (!world.gameOver && ticks < maxTicks) {
+            InputFrame input = PolicyInput(POLICY_SCRIPTED, world);
+            long long before = allocCount;
+            world.step(input);
+            if (ticks >= WARMUP_TICKS) steadyAllocs += allocCount - before;
+            bool fresh = (replayed == 0);
+            if (fresh) ticks++;
+            else replayed--;
+
+            if (ring != NULL) {
+                ring->capture(world);
+                if (fresh && ticks % REWIND_INTERVAL == 0 && ring->rewind(REWIND_TICKS, world)) {
+                    replayed = REWIND_TICKS;
+                    rewinds++;
+                }
+            }
+        }
+        totalTicks += ticks;
+        digest = digest*31 + world.checksum();
+        if (world.gameOver) {
+            if (world.bosses.size() == 0) playerWins++;
+            else bossWins++;
+        }
+    }
+    double seconds = chrono::duration<double>(chrono::steady_clock::now() - start).count();
+
+    printf("matches: %d (players won %d, boss won %d, timed out %d)\n", matches, playerWins, bossWins, matches - playerWins - bossWins);
+    printf("ticks: %lld in %.3f s\n", totalTicks, seconds);
+    printf("throughput: %.1f matches/s, %.0f ticks/s\n", matches/seconds, totalTicks/seconds);
+    printf("workers: %d, checksum: %08x\n", jobs? jobs->workerCount() : 1, digest);
+    if (ring != NULL) {
+        const SnapshotStats &st = ring->stats;
+        printf("snapshots: %ld (%ld keyframes), %.1f kB per tick encoded as %.1f kB, %ld rewinds\n", st.captures, st.keyframes,
+               st.bytesIn/1024.0/st.captures, st.bytesOut/1024.0/st.captures, rewinds);
+    }
+
+#if defined(ENABLE_PROFILER)
+    for (int phase = 0; phase < PHASE_COUNT; phase++) {
+        PhaseStats stats = ProfilerGetStats(phase);
+        if (stats.samples == 0) continue;
+        printf("%-10s p50 %8.2f us  p99 %8.2f us  max %8.2f us\n", ProfilerPhaseName(phase), stats.p50, stats.p99, stats.max);
+    }
+    if (ProfilerWriteTrace("profile_trace.json")) printf("trace written to profile_trace.json\n");
+#endif
+
+    delete ring;
+    delete jobs;
+
+    if (checkAlloc) {
+        printf("steady state heap allocations: %lld\n", steadyAllocs);
+        if (steadyAllocs > 0) return 1;
+    }
+
+    return 0;
+}
@@ -0,0 +1,179 @@
+/*******************************************************************************************
+*
+*   sweep - sort and sweep broadphase on x
+*
+********************************************************************************************/
+
+#include "sweep.h"
+#include <algorithm>
+
+// Left edge first, id on ties, so the order never depends on where the sort started
+struct ByLeftEdge {
+    const float *minX;
+    bool operator()(int a, int b) const { return minX[a] < minX[b] || (minX[a] == minX[b] && a < b); }
+};
+
+static bool pairLess(const SweepPair &p, const SweepPair &q)
+{
+    return p.a < q.a || (p.a == q.a && p.b < q.b);
+}
+
+int SweepAndPrune::addGroup(int capacity)
+{
+    // Reserved in place: a copy of a vector does not keep the capacity
+    groups.push_back(Group());
+    Group &group = groups.back();
+    group.minX.reserve(capacity);
+    group.maxX.reserve(capacity);
+    group.minY.reserve(capacity);
+    group.maxY.reserve(capacity);
+    group.order.reserve(capacity);
+    group.fresh.reserve(capacity);
+    group.renamed.reserve(capacity);
+    group.count = 0;
+    group.resized = false;
+
+    return (int)groups.size() - 1;
+}
+
+void SweepAndPrune::beginGroup(int group, int count)
+{
+    Group &g = groups[group];
+    g.resized = g.resized || count != g.count;
+    g.count = count;
+    g.minX.resize(count);
+    g.maxX.resize(count);
+    g.minY.resize(count);
+    g.maxY.resize(count);
+}
+
+void SweepAndPrune::beginGroup(int group, int count, const int *origin)
+{
+    Group &g = groups[group];
+    int last = g.resized? 0 : (int)g.order.size();
+
+    // Survivors keep their place in the order under their new id, the dead drop out
+    g.renamed.assign(last, -1);
+    g.fresh.clear();
+    for (int id = 0; id < count; id++) {
+        if (origin[id] >= 0 && origin[id] < last) g.renamed[origin[id]] = id;
+        else g.fresh.push_back(id);
+    }
+
+    int kept = 0;
+    for (int k = 0; k < last; k++) {
+        int id = g.renamed[g.order[k]];
+        if (id >= 0) g.order[kept++] = id;
+    }
+    g.order.resize(kept);
+
+    g.resized = false;
+    g.count = count;
+    g.minX.resize(count);
+    g.maxX.resize(count);
+    g.minY.resize(count);
+    g.maxY.resize(count);
+}
+
+void SweepAndPrune::setBox(int group, int id, Rectangle box)
+{
+    Group &g = groups[group];
+    g.minX[id] = box.x - SWEEP_BOX_MARGIN;
+    g.maxX[id] = box.x + box.width + SWEEP_BOX_MARGIN;
+    g.minY[id] = box.y - SWEEP_BOX_MARGIN;
+    g.maxY[id] = box.y + box.height + SWEEP_BOX_MARGIN;
+}
+
+void SweepAndPrune::setCircle(int group, int id, Vector2 center, float radius)
+{
+    Group &g = groups[group];
+    g.minX[id] = center.x - radius;
+    g.maxX[id] = center.x + radius;
+    g.minY[id] = center.y - radius;
+    g.maxY[id] = center.y + radius;
+}
+
+void SweepAndPrune::setSweptCircle(int group, int id, Vector2 from, Vector2 to, float radius)
+{
+    Group &g = groups[group];
+    g.minX[id] = min(from.x, to.x) - radius;
+    g.maxX[id] = max(from.x, to.x) + radius;
+    g.minY[id] = min(from.y, to.y) - radius;
+    g.maxY[id] = max(from.y, to.y) + radius;
+}
+
+void SweepAndPrune::update()
+{
+    for (int i = 0; i < (int)groups.size(); i++) {
+        Group &g = groups[i];
+        ByLeftEdge less = { g.minX.data() };
+
+        if (g.resized) {
+            g.order.resize(g.count);
+            for (int id = 0; id < g.count; id++) g.order[id] = id;
+            sort(g.order.begin(), g.order.end(), less);
+            g.fresh.clear();
+            g.resized = false;
+            continue;
+        }
+
+        // Same ids as last time, each only a few places off
+        int kept = (int)g.order.size();
+        int *order = g.order.data();
+        for (int k = 1; k < kept; k++) {
+            int id = order[k];
+            int j = k - 1;
+            while (j >= 0 && less(id, order[j])) {
+                order[j + 1] = order[j];
+                j--;
+            }
+            order[j + 1] = id;
+        }
+
+        // Newcomers sorted on their own and merged in from the back
+        int added = (int)g.fresh.size();
+        if (added == 0) continue;
+        sort(g.fresh.begin(), g.fresh.end(), less);
+        g.order.resize(kept + added);
+        order = g.order.data();
+        const int *fresh = g.fresh.data();
+        int a = kept - 1;
+        int b = added - 1;
+        for (int w = kept + added - 1; b >= 0; w--) {
+            if (a >= 0 && less(fresh[b], order[a])) order[w] = order[a--];
+            else order[w] = fresh[b--];
+        }
+        g.fresh.clear();
+    }
+}
+
+void SweepAndPrune::findPairs(int groupA, int groupB, vector<SweepPair> &out) const
+{
+    const Group &A = groups[groupA];
+    const Group &B = groups[groupB];
+    out.clear();
+
+    // Whichever of the two next colliders starts first is tested against the ones of the
+    // other group that start before it ends; every pair overlapping on x comes up once
+    int i = 0, j = 0;
+    while (i < A.count && j < B.count) {
+        int a = A.order[i];
+        int b = B.order[j];
+        if (A.minX[a] <= B.minX[b]) {
+            for (int k = j; k < B.count && B.minX[B.order[k]] <= A.maxX[a]; k++) {
+                int other = B.order[k];
+                if (A.minY[a] <= B.maxY[other] && B.minY[other] <= A.maxY[a]) out.push_back((SweepPair){ a, other });
+            }
+            i++;
+        }
+        else {
+            for (int k = i; k < A.count && A.minX[A.order[k]] <= B.maxX[b]; k++) {
+                int other = A.order[k];
+                if (B.minY[b] <= A.maxY[other] && A.minY[other] <= B.maxY[b]) out.push_back((SweepPair){ other, b });
+            }
+            j++;
+        }
+    }
+
+    sort(out.begin(), out.end(), pairLess);
+}
@@ -0,0 +1,68 @@
+/*******************************************************************************************
+*
+*   sweep - sort and sweep broadphase on x
+*
+*   Colliders are registered in groups (one per kind of entity) as bounds: boxes and
+*   circles alike. update() keeps every group sorted by the left edge; a group that kept
+*   its size since the last update is re-sorted with an insertion sort from the previous
+*   order, which is nearly right since nothing moves far in a tick. A group whose ids
+*   come and go (bullets) is begun with where each id was last time: the order drops the
+*   dead ones, renames the rest and only the newcomers get sorted and merged in, so
+*   spawns and removals do not cost a sort from scratch. findPairs() then walks
+*   two sorted groups side by side and only ever looks at pairs overlapping on x, so the
+*   cost follows the pairs that are close rather than the product of the group sizes.
+*
+*   Like the grid it only answers "maybe": the exact test is up to the caller. All storage
+*   is reserved per group when it is added; a steady frame does not allocate.
+*
+********************************************************************************************/
+
+#ifndef SWEEP_H
+#define SWEEP_H
+
+#include "simtypes.h"
+#include <vector>
+using namespace std;
+
+// Boxes grow by this much on every side: circleRecOverlap() rounds the box center to
+// whole pixels, so a hit may reach that far past the real edge
+#define SWEEP_BOX_MARGIN    1.0f
+
+// Ids of two colliders, from the first and the second group of findPairs()
+struct SweepPair {
+    int a;
+    int b;
+};
+
+class SweepAndPrune {
+public:
+    int addGroup(int capacity);                 // group id
+
+    void beginGroup(int group, int count);      // Next update has ids [0, count) in it
+    // Same, origin[id] being the id it had in the last update or -1 if it is new
+    void beginGroup(int group, int count, const int *origin);
+    void setBox(int group, int id, Rectangle box);
+    void setCircle(int group, int id, Vector2 center, float radius);
+    void setSweptCircle(int group, int id, Vector2 from, Vector2 to, float radius);  // everything it passes over
+    void update();                              // Sort the groups by left edge
+
+    // Pairs whose bounds overlap, ascending by a then b
+    void findPairs(int groupA, int groupB, vector<SweepPair> &out) const;
+
+private:
+    struct Group {
+        vector<float> minX;
+        vector<float> maxX;
+        vector<float> minY;
+        vector<float> maxY;
+        vector<int> order;      // ids by left edge, ties by id
+        vector<int> fresh;      // ids new since the last update, to merge into order
+        vector<int> renamed;    // scratch of beginGroup: last update's id to the current one, -1 if gone
+        int count;
+        bool resized;           // count changed since the last update, sort from scratch
+    };
+
+    vector<Group> groups;
+};
+
+#endif // SWEEP_H
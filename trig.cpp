@@ -0,0 +1,20 @@
+/*******************************************************************************************
+*
+*   trig - sine and cosine of whole degrees from a table
+*
+********************************************************************************************/
+
+#include "trig.h"
+
+float trigSinTable[TRIG_TABLE_DEGREES];
+float trigCosTable[TRIG_TABLE_DEGREES];
+
+// Filled before main(); nothing looks an angle up during static initialization
+static struct TrigTableInit {
+    TrigTableInit() {
+        for (int d = 0; d < TRIG_TABLE_DEGREES; d++) {
+            trigSinTable[d] = sinf(d*DEG2RAD);
+            trigCosTable[d] = cosf(d*DEG2RAD);
+        }
+    }
+} trigTableInit;
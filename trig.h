@@ -0,0 +1,40 @@
+/*******************************************************************************************
+*
+*   trig - sine and cosine of whole degrees from a table
+*
+*   Player rotations are multiples of 90, boss spawns and patterns mostly whole degrees, so
+*   most angles the simulation turns into directions are integers. Those come from a table;
+*   any other angle falls back to the library call. The table is filled at startup with
+*   the very same sinf/cosf calls, not generated at compile time: a lookup returns exactly
+*   what the call would have, so results, checksums and recorded replays do not change.
+*
+********************************************************************************************/
+
+#ifndef TRIG_H
+#define TRIG_H
+
+#include "simtypes.h"
+#include <math.h>
+
+// Whole degrees in the table: one turn, plus the half turn added to aim backwards
+#define TRIG_TABLE_DEGREES  720
+
+extern float trigSinTable[TRIG_TABLE_DEGREES];
+extern float trigCosTable[TRIG_TABLE_DEGREES];
+
+// sinf(degrees*DEG2RAD) and cosf(degrees*DEG2RAD), bit for bit
+inline float angleSin(float degrees)
+{
+    int d = (int)degrees;
+    if (d == degrees && d >= 0 && d < TRIG_TABLE_DEGREES) return trigSinTable[d];
+    return sinf(degrees*DEG2RAD);
+}
+
+inline float angleCos(float degrees)
+{
+    int d = (int)degrees;
+    if (d == degrees && d >= 0 && d < TRIG_TABLE_DEGREES) return trigCosTable[d];
+    return cosf(degrees*DEG2RAD);
+}
+
+#endif // TRIG_H
@@ -0,0 +1,878 @@
+/*******************************************************************************************
+*
+*   world - simulation core of "Beat the boss!"
+*
+*   Game logic extracted from the original UpdateGame(). The phases keep their order:
+*   boss logic, player logic, bullet logic, meteor logic and collision logic.
+*
+********************************************************************************************/
+
+#include "world.h"
+#include "profiler.h"
+#include "trig.h"
+#include "log.h"
+#include <algorithm>
+#include <string.h>
+
+//------------------------------------------------------------------------------------
+// Help Functions
+//------------------------------------------------------------------------------------
+// Squares in double are exact for floats, the same result pow() gave without the calls
+float getDistance(float x1, float y1, float x2, float y2) {
+    double dx = x1 - x2;
+    double dy = y1 - y2;
+    return sqrt(dx*dx + dy*dy);
+}
+
+float getDistanceSq(float x1, float y1, float x2, float y2) {
+    float dx = x1 - x2;
+    float dy = y1 - y2;
+    return dx*dx + dy*dy;
+}
+
+int getRotationDirection(int rotation) {
+    if (rotation >= -30 && rotation <= 30) return DIR_UP;   // UP
+    else if (rotation > 30 && rotation < 150) return DIR_RIGHT; // RIGHT
+    else if ((rotation >= 150 && rotation <= 180) || (rotation <= -150 && rotation >= -179)) return DIR_DOWN; // DOWN
+    else return DIR_LEFT;  // LEFT
+}
+
+bool circlesOverlap(Vector2 center1, float radius1, Vector2 center2, float radius2) {
+    float dx = center2.x - center1.x;
+    float dy = center2.y - center1.y;
+    return sqrtf(dx*dx + dy*dy) <= (radius1 + radius2);
+}
+
+bool circleRecOverlap(Vector2 center, float radius, Rectangle rec) {
+    int recCenterX = (int)(rec.x + rec.width/2.0f);
+    int recCenterY = (int)(rec.y + rec.height/2.0f);
+
+    float dx = fabsf(center.x - (float)recCenterX);
+    float dy = fabsf(center.y - (float)recCenterY);
+
+    if (dx > (rec.width/2.0f + radius)) return false;
+    if (dy > (rec.height/2.0f + radius)) return false;
+
+    if (dx <= (rec.width/2.0f)) return true;
+    if (dy <= (rec.height/2.0f)) return true;
+
+    float cornerDistanceSq = (dx - rec.width/2.0f)*(dx - rec.width/2.0f) + (dy - rec.height/2.0f)*(dy - rec.height/2.0f);
+    return cornerDistanceSq <= (radius*radius);
+}
+
+bool recsOverlap(Rectangle rec1, Rectangle rec2) {
+    return (rec1.x < (rec2.x + rec2.width) && (rec1.x + rec1.width) > rec2.x) &&
+           (rec1.y < (rec2.y + rec2.height) && (rec1.y + rec1.height) > rec2.y);
+}
+
+float sweepCircles(Vector2 center1, float radius1, Vector2 motion, Vector2 center2, float radius2) {
+    float dx = center1.x - center2.x;
+    float dy = center1.y - center2.y;
+    float reach = radius1 + radius2;
+
+    float c = dx*dx + dy*dy - reach*reach;
+    if (c <= 0.0f) return 0.0f;     // touching from the start
+    float a = motion.x*motion.x + motion.y*motion.y;
+    float b = dx*motion.x + dy*motion.y;
+    if (a == 0.0f || b >= 0.0f) return -1.0f;   // not moving closer
+
+    float discriminant = b*b - a*c;
+    if (discriminant < 0.0f) return -1.0f;
+    float t = (-b - sqrtf(discriminant))/a;
+    return (t <= 1.0f)? t : -1.0f;
+}
+
+// Circle against the rectangle grown by the radius, with the corners rounded off
+float sweepCircleRec(Vector2 center, float radius, Vector2 motion, Rectangle rec) {
+    float minX = rec.x - radius, maxX = rec.x + rec.width + radius;
+    float minY = rec.y - radius, maxY = rec.y + rec.height + radius;
+
+    // Slab test against the grown rectangle
+    float tEnter = 0.0f, tExit = 1.0f;
+    float start[2] = { center.x, center.y };
+    float step[2] = { motion.x, motion.y };
+    float low[2] = { minX, minY };
+    float high[2] = { maxX, maxY };
+    for (int axis = 0; axis < 2; axis++) {
+        if (step[axis] == 0.0f) {
+            if (start[axis] < low[axis] || start[axis] > high[axis]) return -1.0f;
+            continue;
+        }
+        float t1 = (low[axis] - start[axis])/step[axis];
+        float t2 = (high[axis] - start[axis])/step[axis];
+        if (t1 > t2) { float t = t1; t1 = t2; t2 = t; }
+        if (t1 > tEnter) tEnter = t1;
+        if (t2 < tExit) tExit = t2;
+        if (tEnter > tExit) return -1.0f;
+    }
+
+    // Entering through a corner square only counts if the corner circle is hit
+    float x = center.x + motion.x*tEnter;
+    float y = center.y + motion.y*tEnter;
+    bool outsideX = x < rec.x || x > rec.x + rec.width;
+    bool outsideY = y < rec.y || y > rec.y + rec.height;
+    if (outsideX && outsideY) {
+        Vector2 corner = { (x < rec.x)? rec.x : rec.x + rec.width, (y < rec.y)? rec.y : rec.y + rec.height };
+        return sweepCircles(center, radius, motion, corner, 0.0f);
+    }
+    return tEnter;
+}
+
+SimConfig defaultSimConfig() {
+    SimConfig config;
+    config.bossMaxHp = BOSS_MAX_HP;
+    config.meteorSpeed = METEORS_SPEED;
+    config.attackCycle = ATTACK_CYCLE;
+    config.attackWindow = ATTACK_WINDOW;
+    config.volleyInterval = VOLLEY_INTERVAL;
+    config.playerCount = PLAYER_COUNT;
+    config.bossCount = BOSS_COUNT;
+    return config;
+}
+
+//------------------------------------------------------------------------------------
+// Archetypes
+//------------------------------------------------------------------------------------
+static const ArchetypeDesc playerArchetype = {
+    COMP_TRANSFORM | COMP_MOTION | COMP_COLLIDER | COMP_HEALTH | COMP_SPRITE | COMP_PILOT,
+    PLAYER_SPEED,
+    { -12, -25 }, { 24, 42 },
+    0.0f,               // wall slack, the ship height once init has it
+    false,
+    { 3, 1, 0, 2 }      // sheet row of each DIR_*
+};
+
+static const ArchetypeDesc bossArchetype = {
+    COMP_TRANSFORM | COMP_MOTION | COMP_COLLIDER | COMP_HEALTH | COMP_SPRITE,
+    BOSS_SPEED,
+    { -24, -38 }, { 48, 76 },
+    0.0f,
+    true,
+    { 0, 1, 2, 3 }      // the golem sheet rows are in DIR_* order
+};
+
+// Ship and bullet colors of the players in turn, repeating past the last
+struct PlayerColors {
+    Color ship;
+    Color bullet;
+};
+
+static const PlayerColors playerColors[] = {
+    { RED, MAROON }, { BLUE, DARKBLUE }, { GREEN, DARKGREEN }, { PURPLE, DARKPURPLE },
+    { ORANGE, BROWN }, { SKYBLUE, VIOLET }, { PINK, MAGENTA }, { GOLD, DARKBROWN }
+};
+static const int playerColorCount = sizeof(playerColors)/sizeof(playerColors[0]);
+
+// Turn to the last pressed direction, speed up while holding the one faced, else slow down
+static void steerPlayers(Archetype &players, const InputFrame &input)
+{
+    for (int i = 0; i < players.size(); i++) {
+        unsigned char buttons = input.player[i];
+        if (buttons & INPUT_UP) { players.rotation[i] = 0; players.direction[i] = DIR_UP; }
+        if (buttons & INPUT_DOWN) { players.rotation[i] = 180; players.direction[i] = DIR_DOWN; }
+        if (buttons & INPUT_LEFT) { players.rotation[i] = -90; players.direction[i] = DIR_LEFT; }
+        if (buttons & INPUT_RIGHT) { players.rotation[i] = 90; players.direction[i] = DIR_RIGHT; }
+
+        int dir = players.direction[i];
+        float &acceleration = players.acceleration[i];
+        if (buttons & (1 << dir)) {
+            if (acceleration < 1)
+                acceleration = min(acceleration + 0.04f, 1.0f);
+            players.facing[i] = dir;
+        }
+        else {
+            acceleration = max(0.0f, acceleration - 0.02f);
+        }
+    }
+}
+
+static void turnBoss(Archetype &bosses, int i, Vector2 target, Rng &rng, bool verbose)
+{
+    Vector2 position = bosses.position[i];
+    float &rotation = bosses.rotation[i];
+
+    // if going out of the map
+    if (!(position.x > 0 && position.x < screenWidth && position.y > 0 && position.y < screenHeight)) {
+        rotation += 180;    // reverse direction
+        rotation += rng.nextInt(21) - 10;   // add a small turbulence
+    } else {
+        if (getDistanceSq(position.x, position.y, target.x, target.y) < 15.0f*15.0f) {
+            rotation = rng.nextInt(360);
+        }
+        else {
+            // go straight to the player
+            float dx = target.x - position.x;
+            float dy = target.y - position.y;
+            rotation = atan2(dx, -dy) * RAD2DEG;
+            if (verbose) LOGD("boss rotation: %f\n", rotation);
+        }
+    }
+}
+
+//------------------------------------------------------------------------------------
+// World
+//------------------------------------------------------------------------------------
+World::World() : players(playerArchetype, MAX_PLAYERS), bosses(bossArchetype, MAX_BOSSES), meteors(MAX_METEORS), playerBullets(MAX_BULLETS), bossBullets(MAX_BULLETS),
+    gameOver(false), pause(false), verbose(false), jobs(NULL),
+    meteorGrid(screenWidth, screenHeight, GRID_CELL_SIZE, MAX_METEORS)
+{
+    meteorTaken.reserve(MAX_METEORS);
+    bulletSpent.reserve(MAX_BULLETS);
+    sweepPairs.reserve(MAX_BULLETS);
+    contacts.reserve(4*MAX_BULLETS);
+    hitWorker.reserve(MAX_BULLETS);
+    hitStart.reserve(MAX_BULLETS);
+    hitCount.reserve(MAX_BULLETS);
+    toEraseMeteorId.reserve(MAX_METEORS);
+    toEraseBulletId.reserve(MAX_BULLETS);
+
+    sweepPlayers = actorSweep.addGroup(MAX_PLAYERS);
+    sweepBosses = actorSweep.addGroup(MAX_BOSSES);
+    sweepBullets = actorSweep.addGroup(MAX_BULLETS);
+    playerBullets.trackOrigins();
+
+    // Fixed by the ship shape, so a world restored from a snapshot has it without init
+    shipHeight = (PLAYER_BASE_SIZE/2)/tanf(20*DEG2RAD);
+    players.desc.wallSlack = shipHeight;
+
+    config = defaultSimConfig();
+    framesCounter = 0;
+    events.playerShots = 0;
+    events.bossVolleys = 0;
+
+    setJobSystem(NULL);
+    setPatterns(defaultBossPatterns, defaultBossPatternCount);
+}
+
+void World::setPatterns(const PatternDesc *table, int count)
+{
+    patternTable = table;
+    patternCount = count;
+    applyConfig();
+}
+
+void World::applyConfig()
+{
+    bossPatterns.compile(patternTable, patternCount, config);
+}
+
+void World::setJobSystem(JobSystem *jobSystem)
+{
+    jobs = jobSystem;
+
+    int workers = (jobs != NULL)? jobs->workerCount() : 1;
+    workerCandidates.resize(workers);
+    workerHits.resize(workers);
+    workerHitToi.resize(workers);
+    for (int w = 0; w < workers; w++) {
+        workerCandidates[w].reserve(MAX_METEORS);
+        workerHits[w].reserve(4*MAX_BULLETS);
+        workerHitToi[w].reserve(4*MAX_BULLETS);
+    }
+}
+
+// Initialize game variables
+void World::init(uint32_t matchSeed)
+{
+    int posx, posy;
+    int velx, vely;
+    bool correctRange = false;
+
+    seed = matchSeed;
+    rng.seed(seed);
+    applyConfig();
+
+    pause = false;
+    gameOver = false;
+
+    framesCounter = 0;
+
+    // Initialising player: a row from right to left, two players at a quarter from the sides
+    int playerCount = max(1, min(config.playerCount, MAX_PLAYERS));
+    players.clear();
+    for (int i = 0; i < playerCount; i++) {
+        double across = (playerCount > 1)? 0.75 - 0.5*i/(playerCount - 1) : 0.5;
+        spawnPlayer((int)(screenWidth * across), (int)(screenHeight * 0.75), playerColors[i % playerColorCount].ship);
+    }
+
+    // Initialising boss: evenly spaced, a single one in the middle
+    int bossCount = max(1, min(config.bossCount, MAX_BOSSES));
+    bosses.clear();
+    for (int i = 0; i < bossCount; i++) {
+        spawnBoss((Vector2){(float)screenWidth*(i + 1)/(bossCount + 1), screenHeight / 3.5}, config.bossMaxHp);
+    }
+
+    // Initialising meteors
+    meteors.clear();
+    playerBullets.clear();
+    bossBullets.clear();
+    for (int i = 0; i < MAX_ENV_METEORS; i++)
+    {
+        posx = rng.nextInt(screenWidth + 1);
+
+        while(!correctRange)
+        {
+            if (posx > screenWidth/2 - 150 && posx < screenWidth/2 + 150) posx = rng.nextInt(screenWidth + 1);
+            else correctRange = true;
+        }
+
+        correctRange = false;
+
+        posy = rng.nextInt(screenHeight + 1);
+
+        while(!correctRange)
+        {
+            if (posy > screenHeight/2 - 150 && posy < screenHeight/2 + 150)  posy = rng.nextInt(screenHeight + 1);
+            else correctRange = true;
+        }
+
+        correctRange = false;
+        velx = rng.nextInt(2*(int)config.meteorSpeed + 1) - (int)config.meteorSpeed;
+        vely = rng.nextInt(2*(int)config.meteorSpeed + 1) - (int)config.meteorSpeed;
+
+        while(!correctRange)
+        {
+            if (velx == 0 && vely == 0)
+            {
+                velx = rng.nextInt(2*(int)config.meteorSpeed + 1) - (int)config.meteorSpeed;
+                vely = rng.nextInt(2*(int)config.meteorSpeed + 1) - (int)config.meteorSpeed;
+            }
+            else correctRange = true;
+        }
+        if (rng.nextInt(2)) {
+            meteors.spawn(posx, posy, velx, vely, 20, GRAY, 10);
+        }
+        else {
+            meteors.spawn(posx, posy, velx, vely, 10, DARKGRAY, 10);
+        }
+    }
+}
+
+int World::spawnPlayer(float x, float y, Color color)
+{
+    return players.spawn((Vector2){x, y}, 0, 0, PLAYER_MAX_HP, color);
+}
+
+int World::spawnBoss(Vector2 position, float hp)
+{
+    return bosses.spawn(position, 180, 1.0f, hp, DARKBLUE);
+}
+
+// Update game (one tick)
+void World::step(const InputFrame &input)
+{
+    events.playerShots = 0;
+    events.bossVolleys = 0;
+
+    if (!gameOver)
+    {
+        if (input.system & INPUT_PAUSE) pause = !pause;
+
+        if (!pause)
+        {
+            framesCounter++;
+
+            savePositionSystem(players);
+            savePositionSystem(bosses);
+
+            { PROFILE_SCOPE(PHASE_BOSS); updateBosses(); }
+            { PROFILE_SCOPE(PHASE_PLAYER); updatePlayers(input); }
+            { PROFILE_SCOPE(PHASE_BULLET); updateBullets(input); }
+            { PROFILE_SCOPE(PHASE_METEOR); updateMeteors(); }
+            { PROFILE_SCOPE(PHASE_COLLISION); updateCollisions(); }
+            animationSystem(players);
+            animationSystem(bosses);
+
+            PROFILE_COUNTS((int)bosses.size(), (int)players.size(), meteors.size(), playerBullets.size());
+        }
+    }
+    else
+    {
+        if (input.system & INPUT_RESTART)
+        {
+            init(rng.next());
+        }
+    }
+}
+
+// #########  Boss logic #########
+void World::updateBosses()
+{
+    int playerNum = players.size();
+    int bossNum = bosses.size();
+
+    // TODO: boss movement logic
+    // Rotation
+    if (framesCounter % config.attackCycle == 0) {
+        for (int i = 0; i < bossNum; i++) {
+            int p = rng.nextInt(playerNum); // player target
+            turnBoss(bosses, i, players.position[p], rng, verbose);
+            bosses.facing[i] = getRotationDirection(bosses.rotation[i]);
+            if (verbose) LOGD("boss attack frame row %d\n", bosses.desc.spriteRows[bosses.facing[i]]);
+        }
+    }
+
+    // Speed, movement and wall behavior only touch their own boss
+    movementSystem(bosses, jobs);
+    wallClampSystem(bosses, screenWidth, screenHeight, jobs);
+
+    // boss emit meteor
+    if (inAttackWindow()) { //attackWindow out of every attackCycle frames are attack frames ,edit by yun
+        emitMeteors();
+    }
+}
+
+// The first player on multiples of targetEvery, the others in turn on the other volleys; a
+// dead target passes to the next living player
+int World::aimTarget(const PatternDesc &desc, int cadence) const
+{
+    int playerNum = players.size();
+    if (playerNum == 1) return 0;
+
+    int target = (desc.targetEvery > 0 && framesCounter % desc.targetEvery == 0)? 0 : 1 + (framesCounter/cadence) % (playerNum - 1);
+    for (int k = 1; k < playerNum && players.hp[target] <= 0; k++) target = (target + 1) % playerNum;
+    return target;
+}
+
+// Every boss fires the patterns of its HP phase that are due this tick, straight from the
+// compiled rows; aimed ones only need their aim worked out
+void World::emitMeteors()
+{
+    const vector<CompiledPattern> &patterns = bossPatterns.patterns;
+
+    for (int b = 0; b < bosses.size(); b++) {
+        for (int p = 0; p < (int)patterns.size(); p++) {
+            const CompiledPattern &c = patterns[p];
+            const PatternDesc &desc = *c.desc;
+            if (framesCounter % c.cadence != c.offset) continue;
+            if (bosses.hp[b] < c.hpMin || !(bosses.hp[b] < c.hpMax)) continue;
+
+            events.bossVolleys++;
+
+            int first = c.firstShot + bossPatterns.row(p, framesCounter, config.attackCycle)*c.count;
+            const float *velx = &bossPatterns.shotX[first];
+            const float *vely = &bossPatterns.shotY[first];
+
+            if (desc.aim == AIM_PLAYER) {
+                int target = aimTarget(desc, c.cadence);
+
+                // the larger the distance, the faster the speed
+                float aimx = (players.position[target].x - bosses.position[b].x);
+                float aimy = (players.position[target].y - bosses.position[b].y);
+                float s = sqrt((double)aimx*aimx + (double)aimy*aimy);
+                aimx = aimx / s * c.speed;
+                aimy = aimy / s * c.speed;
+
+                float *outx = bossPatterns.volleyX.data();
+                float *outy = bossPatterns.volleyY.data();
+                for (int k = 0; k < c.count; k++) {
+                    outx[k] = aimx*velx[k] - aimy*vely[k];
+                    outy[k] = aimy*velx[k] + aimx*vely[k];
+                }
+                velx = outx;
+                vely = outy;
+            }
+
+            float radius = (desc.bigEvery > 0 && framesCounter % desc.bigEvery == 0)? c.bigRadius : c.radius;
+            int spawned = meteors.spawnVolley(bosses.position[b].x, bosses.position[b].y, velx, vely, c.count, radius, desc.color, desc.damage);
+            if (verbose) LOGD("boss %d volley %s: %d meteors\n", b, desc.name, spawned);
+        }
+    }
+}
+
+// #########  Player logic #########
+void World::updatePlayers(const InputFrame &input)
+{
+    // Rotation and controller
+    steerPlayers(players, input);
+
+    // Speed, movement and wall behaviour
+    movementSystem(players, jobs);
+    wallClampSystem(players, screenWidth, screenHeight, jobs);
+}
+
+// #########  Bullet logic #########
+void World::updateBullets(const InputFrame &input)
+{
+    // Bullet Emission
+    for (int i = 0; i < players.size(); i++) {
+        if ((input.player[i] & INPUT_FIRE) && players.hp[i] > 0) {
+            float velx = angleSin(players.rotation[i] + 0)*PLAYER_BULLET_SPEED;
+            float vely = angleCos(players.rotation[i] + 180)*PLAYER_BULLET_SPEED;
+            playerBullets.spawn(players.position[i].x, players.position[i].y, velx, vely, 5, playerColors[i % playerColorCount].bullet, 10);
+            events.playerShots++;
+        }
+    }
+
+    // movement and wall behaviour
+    playerBullets.integrateAndCull(screenWidth, screenHeight, jobs);
+}
+
+// #########  Meteor logic #########
+void World::updateMeteors()
+{
+    // movement and wall behaviour
+    meteors.integrateAndCull(screenWidth, screenHeight, jobs);
+}
+
+// #########  Collision logic #########
+// Time of impact of a fast projectile on a moving circle over the last tick, -1 for a
+// miss; an overlap at the end positions that the sweep rounds away counts at the end
+static float sweptHit(const ProjectilePool &pool, int i, const ProjectilePool &targets, int t)
+{
+    Vector2 from = { pool.prevX[i], pool.prevY[i] };
+    Vector2 motion = { (pool.x[i] - pool.prevX[i]) - (targets.x[t] - targets.prevX[t]),
+                       (pool.y[i] - pool.prevY[i]) - (targets.y[t] - targets.prevY[t]) };
+    float toi = sweepCircles(from, pool.r[i], motion, (Vector2){ targets.prevX[t], targets.prevY[t] }, targets.r[t]);
+    if (toi < 0.0f && circlesOverlap(pool.position(i), pool.r[i], targets.position(t), targets.r[t])) toi = 1.0f;
+    return toi;
+}
+
+// Same against a box that moved by boxMotion, swept in the box's final frame
+static float sweptHit(const ProjectilePool &pool, int i, Rectangle box, Vector2 boxMotion)
+{
+    Vector2 from = { pool.prevX[i] + boxMotion.x, pool.prevY[i] + boxMotion.y };
+    Vector2 motion = { pool.x[i] - from.x, pool.y[i] - from.y };
+    float toi = sweepCircleRec(from, pool.r[i], motion, box);
+    if (toi < 0.0f && circleRecOverlap(pool.position(i), pool.r[i], box)) toi = 1.0f;
+    return toi;
+}
+
+void World::updateCollisions()
+{
+    colliderSyncSystem(players);
+    colliderSyncSystem(bosses);
+
+    findContacts();
+    resolveContacts();
+}
+
+// Every overlap of the tick into one contact list. Meteors are many and spread out, so
+// players and bullets find theirs through the grid once there are enough pairs; players,
+// bosses and bullets are few and go through the sweep. Fast bullets (PROJ_FAST) are
+// tested along their whole path so they cannot step over a target
+void World::findContacts()
+{
+    int playerNum = players.size();
+    int bulletNum = playerBullets.size();
+    contacts.clear();
+
+    // Players, bosses and bullets into the sweep; a fast bullet covers its path, widened
+    // by what a boss may have moved meanwhile
+    int fastBullets = 0;
+    actorSweep.beginGroup(sweepPlayers, playerNum);
+    for (int i = 0; i < playerNum; i++) actorSweep.setBox(sweepPlayers, i, players.collider[i]);
+    actorSweep.beginGroup(sweepBosses, bosses.size());
+    for (int i = 0; i < bosses.size(); i++) actorSweep.setBox(sweepBosses, i, bosses.collider[i]);
+    actorSweep.beginGroup(sweepBullets, bulletNum, playerBullets.origin.data());
+    playerBullets.markOrigins();
+    for (int i = 0; i < bulletNum; i++) {
+        if (playerBullets.flags[i] & PROJ_FAST) {
+            Vector2 from = { playerBullets.prevX[i], playerBullets.prevY[i] };
+            actorSweep.setSweptCircle(sweepBullets, i, from, playerBullets.position(i), playerBullets.r[i] + bosses.desc.moveSpeed);
+            fastBullets++;
+        }
+        else {
+            actorSweep.setCircle(sweepBullets, i, playerBullets.position(i), playerBullets.r[i]);
+        }
+    }
+    actorSweep.update();
+
+    // Fast bullets look for meteors as far as one may have come towards them
+    float meteorStep = 0.0f;
+    if (fastBullets > 0) {
+        for (int m_id = 0; m_id < meteors.size(); m_id++) {
+            meteorStep = max(meteorStep, meteors.vx[m_id]*meteors.vx[m_id] + meteors.vy[m_id]*meteors.vy[m_id]);
+        }
+        meteorStep = sqrtf(meteorStep);
+    }
+
+    // A couple of players alone are cheaper to test against every meteor than a rebuild
+    bool useGrid = bulletNum*meteors.size() > GRID_MIN_PAIRS ||
+                   (playerNum > GRID_MIN_QUERIES && playerNum*meteors.size() > GRID_MIN_PAIRS);
+    if (useGrid) {
+        meteorGrid.reset(meteors.size());
+        for (int m_id = 0; m_id < meteors.size(); m_id++) {
+            meteorGrid.insert(m_id, meteors.position(m_id));
+        }
+        meteorGrid.finalize();
+    }
+
+    // Player to meteors, dead players are out of the game
+    contactStart[CONTACT_PLAYER_METEOR] = 0;
+    for (int i = 0; i < playerNum; i++) {
+        if (players.hp[i] <= 0) continue;
+        Rectangle collider = players.collider[i];
+        if (useGrid) {
+            vector<int> &candidates = workerCandidates[0];
+            Vector2 center = { collider.x + collider.width/2, collider.y + collider.height/2 };
+            float reach = max(collider.width, collider.height)/2 + METEOR_MAX_RADIUS + SWEEP_BOX_MARGIN;
+            candidates.clear();
+            meteorGrid.query(center, reach, candidates);
+            for (int k = 0; k < (int)candidates.size(); k++) {
+                int m_id = candidates[k];
+                if (circleRecOverlap(meteors.position(m_id), meteors.r[m_id], collider) && meteors.active(m_id)) {
+                    contacts.push_back((Contact){ CONTACT_PLAYER_METEOR, i, m_id, 1.0f });
+                }
+            }
+        }
+        else {
+            for (int m_id = 0; m_id < meteors.size(); m_id++) {
+                if (circleRecOverlap(meteors.position(m_id), meteors.r[m_id], collider) && meteors.active(m_id)) {
+                    contacts.push_back((Contact){ CONTACT_PLAYER_METEOR, i, m_id, 1.0f });
+                }
+            }
+        }
+    }
+
+    // Bullet to meteors
+    contactStart[CONTACT_BULLET_METEOR] = (int)contacts.size();
+    if (useGrid) {
+        // Find every overlapping meteor of every bullet, in parallel
+        for (int w = 0; w < (int)workerHits.size(); w++) {
+            workerHits[w].clear();
+            workerHitToi[w].clear();
+        }
+        hitWorker.resize(bulletNum);
+        hitStart.resize(bulletNum);
+        hitCount.resize(bulletNum);
+        ParallelFor(jobs, bulletNum, JOB_GRAIN_BULLETS, [this, meteorStep](int begin, int end, int worker) {
+            vector<int> &candidates = workerCandidates[worker];
+            vector<int> &hits = workerHits[worker];
+            vector<float> &hitToi = workerHitToi[worker];
+            for (int b_id = begin; b_id < end; b_id++) {
+                hitWorker[b_id] = worker;
+                hitStart[b_id] = (int)hits.size();
+                if (playerBullets.active(b_id) && (playerBullets.flags[b_id] & PROJ_FAST)) {
+                    // Around the middle of the path, far enough for either end
+                    float dx = playerBullets.x[b_id] - playerBullets.prevX[b_id];
+                    float dy = playerBullets.y[b_id] - playerBullets.prevY[b_id];
+                    Vector2 middle = { playerBullets.prevX[b_id] + dx/2, playerBullets.prevY[b_id] + dy/2 };
+                    float reach = sqrtf(dx*dx + dy*dy)/2 + playerBullets.r[b_id] + METEOR_MAX_RADIUS + meteorStep;
+                    candidates.clear();
+                    meteorGrid.query(middle, reach, candidates);
+                    for (int k = 0; k < (int)candidates.size(); k++) {
+                        int m_id = candidates[k];
+                        if (!meteors.active(m_id)) continue;
+                        float toi = sweptHit(playerBullets, b_id, meteors, m_id);
+                        if (toi >= 0.0f) {
+                            hits.push_back(m_id);
+                            hitToi.push_back(toi);
+                        }
+                    }
+                }
+                else if (playerBullets.active(b_id)) {
+                    Vector2 bulletPos = playerBullets.position(b_id);
+                    float bulletRadius = playerBullets.r[b_id];
+                    candidates.clear();
+                    meteorGrid.query(bulletPos, bulletRadius + METEOR_MAX_RADIUS, candidates);
+                    for (int k = 0; k < (int)candidates.size(); k++) {
+                        int m_id = candidates[k];
+                        if (circlesOverlap(bulletPos, bulletRadius, meteors.position(m_id), meteors.r[m_id]) && meteors.active(m_id)) {
+                            hits.push_back(m_id);
+                            hitToi.push_back(1.0f);
+                        }
+                    }
+                }
+                hitCount[b_id] = (int)hits.size() - hitStart[b_id];
+            }
+        });
+
+        // Merged in bullet order, whoever found them
+        for (int b_id = 0; b_id < bulletNum; b_id++) {
+            const int *hits = workerHits[hitWorker[b_id]].data() + hitStart[b_id];
+            const float *hitToi = workerHitToi[hitWorker[b_id]].data() + hitStart[b_id];
+            for (int k = 0; k < hitCount[b_id]; k++) {
+                contacts.push_back((Contact){ CONTACT_BULLET_METEOR, b_id, hits[k], hitToi[k] });
+            }
+        }
+    }
+    else {
+        for (int b_id = 0; b_id < bulletNum; b_id++) {
+            if (!playerBullets.active(b_id)) continue;
+            bool fast = (playerBullets.flags[b_id] & PROJ_FAST) != 0;
+            Vector2 bulletPos = playerBullets.position(b_id);
+            float bulletRadius = playerBullets.r[b_id];
+            for (int m_id = 0; m_id < meteors.size(); m_id++) {
+                if (!meteors.active(m_id)) continue;
+                float toi = fast? sweptHit(playerBullets, b_id, meteors, m_id) :
+                            circlesOverlap(bulletPos, bulletRadius, meteors.position(m_id), meteors.r[m_id])? 1.0f : -1.0f;
+                if (toi >= 0.0f) contacts.push_back((Contact){ CONTACT_BULLET_METEOR, b_id, m_id, toi });
+            }
+        }
+    }
+
+    // Bullet to boss
+    contactStart[CONTACT_BULLET_BOSS] = (int)contacts.size();
+    actorSweep.findPairs(sweepBullets, sweepBosses, sweepPairs);
+    for (int k = 0; k < (int)sweepPairs.size(); k++) {
+        int bulletId = sweepPairs[k].a, bossId = sweepPairs[k].b;
+        if (!playerBullets.active(bulletId)) continue;
+        float toi;
+        if (playerBullets.flags[bulletId] & PROJ_FAST) {
+            Vector2 bossMotion = { bosses.position[bossId].x - bosses.prevPosition[bossId].x,
+                                   bosses.position[bossId].y - bosses.prevPosition[bossId].y };
+            toi = sweptHit(playerBullets, bulletId, bosses.collider[bossId], bossMotion);
+        }
+        else {
+            toi = circleRecOverlap(playerBullets.position(bulletId), playerBullets.r[bulletId], bosses.collider[bossId])? 1.0f : -1.0f;
+        }
+        if (toi >= 0.0f) contacts.push_back((Contact){ CONTACT_BULLET_BOSS, bulletId, bossId, toi });
+    }
+
+    // Player to boss
+    contactStart[CONTACT_PLAYER_BOSS] = (int)contacts.size();
+    actorSweep.findPairs(sweepPlayers, sweepBosses, sweepPairs);
+    for (int k = 0; k < (int)sweepPairs.size(); k++) {
+        int playerId = sweepPairs[k].a, bossId = sweepPairs[k].b;
+        if (players.hp[playerId] > 0 && recsOverlap(players.collider[playerId], bosses.collider[bossId])) {
+            contacts.push_back((Contact){ CONTACT_PLAYER_BOSS, playerId, bossId, 1.0f });
+        }
+    }
+    contactStart[CONTACT_KIND_COUNT] = (int)contacts.size();
+}
+
+// Damage from the contact list. Indices are the ones of the start of the collision phase:
+// meteors, bullets and bosses are only removed at the end, what is used up is marked
+void World::resolveContacts()
+{
+    const Contact *contact = contacts.data();
+
+    // Player to meteors: every meteor no earlier player took hurts
+    meteorTaken.assign(meteors.size(), 0);
+    for (int c = contactStart[CONTACT_PLAYER_METEOR]; c < contactStart[CONTACT_PLAYER_METEOR + 1]; c++) {
+        if (meteorTaken[contact[c].b]) continue;
+        players.hp[contact[c].a] -= 10;
+        meteorTaken[contact[c].b] = 1;
+    }
+    if (damageSystem(players) == 0) gameOver = true;
+
+    // Bullet to meteors: each bullet takes the first meteor on its way that is still there,
+    // the lowest indexed one on a tie (always, for bullets tested at their end position)
+    bulletSpent.assign(playerBullets.size(), 0);
+    for (int c = contactStart[CONTACT_BULLET_METEOR]; c < contactStart[CONTACT_BULLET_METEOR + 1]; ) {
+        int bulletId = contact[c].a;
+        int hit = -1;
+        float hitToi = 0.0f;
+        for (; c < contactStart[CONTACT_BULLET_METEOR + 1] && contact[c].a == bulletId; c++) {
+            if (meteorTaken[contact[c].b]) continue;
+            if (hit < 0 || contact[c].toi < hitToi || (contact[c].toi == hitToi && contact[c].b < hit)) {
+                hit = contact[c].b;
+                hitToi = contact[c].toi;
+            }
+        }
+        if (hit >= 0) {
+            meteorTaken[hit] = 1;
+            bulletSpent[bulletId] = 1;
+        }
+    }
+    toEraseMeteorId.clear();
+    for (int m_id = 0; m_id < meteors.size(); m_id++) {
+        if (meteorTaken[m_id]) toEraseMeteorId.push_back(m_id);
+    }
+    meteors.removeSorted(toEraseMeteorId);
+
+    // Bullet to boss: a bullet left hits the first boss still alive on its way, the lowest
+    // indexed one on a tie (contacts of a bullet come by ascending boss)
+    for (int c = contactStart[CONTACT_BULLET_BOSS]; c < contactStart[CONTACT_BULLET_BOSS + 1]; ) {
+        int bulletId = contact[c].a;
+        int hit = -1;
+        float hitToi = 0.0f;
+        for (; c < contactStart[CONTACT_BULLET_BOSS + 1] && contact[c].a == bulletId; c++) {
+            if (bosses.hp[contact[c].b] > 0 && (hit < 0 || contact[c].toi < hitToi)) {
+                hit = contact[c].b;
+                hitToi = contact[c].toi;
+            }
+        }
+        if (hit >= 0 && !bulletSpent[bulletId]) {
+            bosses.hp[hit] -= playerBullets.damage[bulletId];
+            bulletSpent[bulletId] = 1;
+        }
+    }
+    toEraseBulletId.clear();
+    for (int b_id = 0; b_id < playerBullets.size(); b_id++) {
+        if (bulletSpent[b_id]) toEraseBulletId.push_back(b_id);
+    }
+    playerBullets.removeSorted(toEraseBulletId);
+
+    // Player to boss: a live player bounces off the lowest indexed boss still alive it overlaps
+    for (int c = contactStart[CONTACT_PLAYER_BOSS]; c < contactStart[CONTACT_PLAYER_BOSS + 1]; ) {
+        int i = contact[c].a;
+        int hit = -1;
+        for (; c < contactStart[CONTACT_PLAYER_BOSS + 1] && contact[c].a == i; c++) {
+            if (hit < 0 && bosses.hp[contact[c].b] > 0) hit = contact[c].b;
+        }
+        if (hit >= 0 && players.hp[i] > 0) {
+            players.hp[i] -= 5;
+            // player bounce away when hit by boss
+            players.position[i].x -= players.speed[i].x*5;
+            players.position[i].y -= players.speed[i].y*5;
+            players.acceleration[i] = 0;
+        }
+    }
+
+    if (damageSystem(bosses) == 0) {
+        gameOver = true;
+    }
+    if (damageSystem(players) == 0) gameOver = true;
+}
+
+//------------------------------------------------------------------------------------
+// Checksum
+//------------------------------------------------------------------------------------
+
+// FNV-1a over raw bytes; floats are hashed bit for bit on purpose
+static uint32_t hashBytes(uint32_t hash, const void *data, size_t size)
+{
+    const unsigned char *bytes = (const unsigned char *)data;
+    for (size_t i = 0; i < size; i++) {
+        hash ^= bytes[i];
+        hash *= 16777619u;
+    }
+    return hash;
+}
+
+template <class T>
+static uint32_t hashColumn(uint32_t hash, const vector<T> &column)
+{
+    return column.empty()? hash : hashBytes(hash, column.data(), column.size()*sizeof(T));
+}
+
+static uint32_t hashPool(uint32_t hash, const ProjectilePool &pool)
+{
+    hash = hashColumn(hash, pool.x);
+    hash = hashColumn(hash, pool.y);
+    hash = hashColumn(hash, pool.vx);
+    hash = hashColumn(hash, pool.vy);
+    hash = hashColumn(hash, pool.r);
+    hash = hashColumn(hash, pool.flags);
+    return hashColumn(hash, pool.damage);
+}
+
+uint32_t World::checksum() const
+{
+    uint32_t hash = 2166136261u;
+
+    hash = hashBytes(hash, &framesCounter, sizeof(framesCounter));
+    hash = hashBytes(hash, &gameOver, sizeof(gameOver));
+    hash = hashBytes(hash, &pause, sizeof(pause));
+    hash = hashBytes(hash, &rng.state, sizeof(rng.state));
+
+    // Entity by entity, so checksums recorded before the archetype storage still match
+    for (int i = 0; i < players.size(); i++) {
+        hash = hashBytes(hash, &players.position[i], sizeof(Vector2));
+        hash = hashBytes(hash, &players.speed[i], sizeof(Vector2));
+        hash = hashBytes(hash, &players.acceleration[i], sizeof(float));
+        hash = hashBytes(hash, &players.rotation[i], sizeof(float));
+        hash = hashBytes(hash, &players.hp[i], sizeof(float));
+    }
+    for (int i = 0; i < bosses.size(); i++) {
+        hash = hashBytes(hash, &bosses.position[i], sizeof(Vector2));
+        hash = hashBytes(hash, &bosses.speed[i], sizeof(Vector2));
+        hash = hashBytes(hash, &bosses.rotation[i], sizeof(float));
+        hash = hashBytes(hash, &bosses.hp[i], sizeof(float));
+    }
+
+    hash = hashPool(hash, meteors);
+    return hashPool(hash, playerBullets);
+}
@@ -0,0 +1,227 @@
+/*******************************************************************************************
+*
+*   world - simulation core of "Beat the boss!"
+*
+*   Players, bosses, meteors and bullets are advanced here one tick at a time from an
+*   InputFrame. Nothing in this module touches the window, the keyboard or the audio
+*   device, so it can be built with SIM_HEADLESS (no raylib at all) and stepped uncapped.
+*
+*   Players and bosses are rows of two archetypes (ecs.h) moved, clamped and hurt by the
+*   shared systems; meteors and bullets live in ProjectilePools. What the bosses fire is a
+*   pattern table (pattern.h), compiled against the SimConfig at init.
+*
+********************************************************************************************/
+
+#ifndef WORLD_H
+#define WORLD_H
+
+#include "simtypes.h"
+#include "grid.h"
+#include "sweep.h"
+#include "projectile.h"
+#include "ecs.h"
+#include "pattern.h"
+#include "jobs.h"
+#include "rng.h"
+#include <math.h>
+#include <vector>
+using namespace std;
+
+//----------------------------------------------------------------------------------
+// Some Defines
+//----------------------------------------------------------------------------------
+#define PLAYER_BASE_SIZE    20.0f
+#define PLAYER_SPEED        2.4f
+#define PLAYER_MAX_SHOOTS   10
+#define PLAYER_MAX_HP       50
+
+#define MAX_ENV_METEORS     0
+#define METEORS_SPEED       2.0f
+#define METEOR_MAX_RADIUS   20.0f
+
+#define PLAYER_BULLET_SPEED 5.0f
+#define BOSS_BULLET_SPEED   3.0f
+
+#define BOSS_BASE_SIZE      50.0f
+#define BOSS_SPEED          1.0f
+#define BOSS_MAX_HP         250
+
+// Boss attack timing: bosses turn at the start of every cycle and volley every
+// VOLLEY_INTERVAL ticks during the first ATTACK_WINDOW ticks of it
+#define ATTACK_CYCLE        300
+#define ATTACK_WINDOW       70
+#define VOLLEY_INTERVAL     50
+
+#define DIR_UP              0
+#define DIR_LEFT            1
+#define DIR_DOWN            2
+#define DIR_RIGHT           3
+
+// Players and bosses of a new match, SimConfig playerCount and bossCount by default
+#define PLAYER_COUNT        2
+#define BOSS_COUNT          1
+
+// Simulation rate; every per tick speed and frame count above assumes it
+#define TICK_RATE           60
+#define TICK_DT             (1.0f/TICK_RATE)
+
+// Fixed pool capacities, allocated once per World; spawns beyond them are dropped
+#define MAX_PLAYERS         16
+#define MAX_BOSSES          64
+#define MAX_METEORS         131072
+#define MAX_BULLETS         4096
+
+// Smallest loop chunk handed to a job worker, per kind of work
+#define JOB_GRAIN_BULLETS   16      // grid queries, a few hundred candidates each
+#define JOB_GRAIN_METEORS   8192
+
+// Per player input bits (directions are held, fire is the press edge)
+#define INPUT_UP            (1 << DIR_UP)
+#define INPUT_LEFT          (1 << DIR_LEFT)
+#define INPUT_DOWN          (1 << DIR_DOWN)
+#define INPUT_RIGHT         (1 << DIR_RIGHT)
+#define INPUT_FIRE          (1 << 4)
+
+// System input bits
+#define INPUT_PAUSE         (1 << 0)
+#define INPUT_RESTART       (1 << 1)
+
+static const int screenWidth = 800;
+static const int screenHeight = 800;
+
+//------------------------------------------------------------------------------------
+// Help Functions Declaration
+//------------------------------------------------------------------------------------
+float getDistance(float x1, float y1, float x2, float y2);
+float getDistanceSq(float x1, float y1, float x2, float y2);   // to compare against a squared bound, no sqrt
+int getRotationDirection(int rotation);
+
+// Same tests as raylib's CheckCollision* so headless and windowed runs agree
+bool circlesOverlap(Vector2 center1, float radius1, Vector2 center2, float radius2);
+bool circleRecOverlap(Vector2 center, float radius, Rectangle rec);
+bool recsOverlap(Rectangle rec1, Rectangle rec2);
+
+// Swept tests: the circle starts at center and moves by motion over the tick, the other
+// shape stays put (pass the relative motion when both move). Time of impact in [0, 1],
+// -1 when they never touch
+float sweepCircles(Vector2 center1, float radius1, Vector2 motion, Vector2 center2, float radius2);
+float sweepCircleRec(Vector2 center, float radius, Vector2 motion, Rectangle rec);
+
+//----------------------------------------------------------------------------------
+// Types and Structures Definition
+//----------------------------------------------------------------------------------
+
+// Everything the simulation reads from the outside world during one tick
+struct InputFrame {
+    unsigned char player[MAX_PLAYERS];  // INPUT_UP | INPUT_LEFT | ... | INPUT_FIRE
+    unsigned char system;               // INPUT_PAUSE | INPUT_RESTART
+};
+
+// Balance knobs of a match, the defines above by default; set before World::init
+struct SimConfig {
+    float bossMaxHp;
+    float meteorSpeed;
+    int attackCycle;
+    int attackWindow;
+    int volleyInterval;
+    int playerCount;        // 1 to MAX_PLAYERS, spread along the bottom of the arena
+    int bossCount;          // 1 to MAX_BOSSES, spread along the top
+};
+
+SimConfig defaultSimConfig();
+
+// Collisions of a tick, resolved kind by kind in this order
+enum ContactKind {
+    CONTACT_PLAYER_METEOR = 0,
+    CONTACT_BULLET_METEOR,
+    CONTACT_BULLET_BOSS,
+    CONTACT_PLAYER_BOSS,
+    CONTACT_KIND_COUNT
+};
+
+// a is the player or bullet, b the meteor or boss; contacts of a kind are grouped by a
+struct Contact {
+    int kind;
+    int a;
+    int b;
+    float toi;      // time of impact in the tick, 1 when found at the end positions
+};
+
+// Things that happened during the last tick the front-end may want to react to
+struct StepEvents {
+    int playerShots;
+    int bossVolleys;
+};
+
+class World {
+public:
+    Archetype players;              // one row per player, never removed (dead ones keep hp <= 0)
+    Archetype bosses;               // removed once dead
+    ProjectilePool meteors;         // Meteors are emited by boss
+    ProjectilePool playerBullets;   // Bullet are emited by player or boss
+    ProjectilePool bossBullets;
+
+    SimConfig config;
+    uint32_t seed;          // seed of the current match
+    Rng rng;                // every random decision of the match draws from here
+    int framesCounter;
+    bool gameOver;
+    bool pause;
+    bool verbose;           // debug traces through the log (log.h), off by default
+    StepEvents events;      // reset at the start of every step
+    JobSystem *jobs;        // optional, NULL runs every phase on the calling thread
+
+    World();
+    void setJobSystem(JobSystem *jobSystem);   // Split phases across workers, same results
+    void setPatterns(const PatternDesc *table, int count);  // Boss attacks, defaultBossPatterns until set
+    void init(uint32_t matchSeed);          // Initialize match
+    void applyConfig();                     // Recompile what depends on config (init does it)
+    void step(const InputFrame &input);     // Advance one tick
+    uint32_t checksum() const;              // Hash of the simulated state, to compare runs
+
+    int spawnPlayer(float x, float y, Color color);     // row, -1 when full
+    int spawnBoss(Vector2 position, float hp);
+
+    bool inAttackWindow() const { return framesCounter % config.attackCycle < config.attackWindow; }
+
+private:
+    float shipHeight;
+    const PatternDesc *patternTable;
+    int patternCount;
+    PatternSchedule bossPatterns;
+
+    // Scratch buffers, sized once so a steady step does not touch the heap
+    UniformGrid meteorGrid;
+    SweepAndPrune actorSweep;       // players and bosses as boxes, bullets as circles
+    int sweepPlayers;
+    int sweepBosses;
+    int sweepBullets;
+    vector<SweepPair> sweepPairs;
+    vector<Contact> contacts;       // every collision of the tick, by ContactKind
+    int contactStart[CONTACT_KIND_COUNT + 1];
+    vector<char> meteorTaken;
+    vector<char> bulletSpent;
+
+    // Per worker collision buffers: each bullet's overlapping meteors land in the buffer
+    // of whichever worker tested it and are merged back in bullet order
+    vector<vector<int> > workerCandidates;
+    vector<vector<int> > workerHits;
+    vector<vector<float> > workerHitToi;
+    vector<int> hitWorker;
+    vector<int> hitStart;
+    vector<int> hitCount;
+    vector<int> toEraseMeteorId;
+    vector<int> toEraseBulletId;
+
+    void updateBosses();
+    void emitMeteors();
+    int aimTarget(const PatternDesc &desc, int cadence) const;  // player an AIM_PLAYER volley goes for
+    void updatePlayers(const InputFrame &input);
+    void updateBullets(const InputFrame &input);
+    void updateMeteors();
+    void updateCollisions();
+    void findContacts();
+    void resolveContacts();
+};
+
+#endif // WORLD_H